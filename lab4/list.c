@@ -27,6 +27,10 @@ typedef struct list {
   struct node *head;
   // List also has a compare function implemented in driver main function
   int (*compare)(void *, void *);
+  // What findItem does with an item it finds, see list.h
+  int policy;
+  // Number of calls to compare made by findItem and removeItem
+  long compares;
 } LIST;
 
 // Define struct for node
@@ -58,6 +62,8 @@ LIST *createList(int (*compare)()) {
   // Set compare to function pointer and initialize the count
   list->compare = compare;
   list->count = 0;
+  list->policy = REORDER_NONE;
+  list->compares = 0;
 
   return list;
 }
@@ -208,6 +214,7 @@ void removeItem(LIST *lp, void *item) {
   NODE *current;
   // Start searching from the first node and look until we return to the head
   for (current = lp->head->next; current != lp->head; current = current->next) {
+    lp->compares++;
     if (lp->compare(item, current->data) == 0) { // if node's data matches item
       // Shift pointers to delete node
       current->prev->next = current->next;
@@ -223,7 +230,8 @@ void removeItem(LIST *lp, void *item) {
   return;
 }
 
-// Find and return node's data that matches the given item
+// Find and return node's data that matches the given item, then reorder the
+// list according to lp->policy
 // Big O = O(lp->count)
 void *findItem(LIST *lp, void *item) {
   // Check that lp and item are valid and that list is not empty
@@ -232,7 +240,29 @@ void *findItem(LIST *lp, void *item) {
   NODE *current;
   // Start searching from the first node and look until we return to the head
   for (current = lp->head->next; current != lp->head; current = current->next) {
+    lp->compares++;
     if (lp->compare(item, current->data) == 0) { // if node's data matches item
+      // Already in front, nothing to reorder
+      if (current->prev == lp->head) {
+        return (current->data);
+      }
+
+      if (lp->policy == REORDER_MTF) {
+        // Unlink node and insert it right after head
+        current->prev->next = current->next;
+        current->next->prev = current->prev;
+        current->next = lp->head->next;
+        current->prev = lp->head;
+        lp->head->next->prev = current;
+        lp->head->next = current;
+      } else if (lp->policy == REORDER_TRANSPOSE) {
+        // Swapping data with the previous node moves the item one step up
+        void *data = current->data;
+        current->data = current->prev->data;
+        current->prev->data = data;
+        current = current->prev;
+      }
+
       return (current->data);
     }
   }
@@ -261,3 +291,22 @@ void *getItems(LIST *lp) {
 
   return items;
 }
+
+// Choose what findItem does with the items it finds. With REORDER_MTF or
+// REORDER_TRANSPOSE frequently searched items end up near the front, which
+// makes searches cheaper when a few items are searched much more than others
+// Big O = O(1)
+void reorderList(LIST *lp, int policy) {
+  assert(lp != NULL);
+  assert(policy == REORDER_NONE || policy == REORDER_MTF ||
+         policy == REORDER_TRANSPOSE);
+
+  lp->policy = policy;
+}
+
+// Return the number of comparisons made by findItem and removeItem so far
+// Big O = O(1)
+long numCompares(LIST *lp) {
+  assert(lp != NULL);
+  return (lp->compares);
+}
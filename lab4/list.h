@@ -7,12 +7,18 @@
  *		declarations for a list abstract data type for generic
  *		pointer types.  The list supports deque operations, in
  *		which items can be easily added to or removed from the
- *		front or rear of the list.
+ *		front or rear of the list.  Searches may optionally
+ *		reorder the list so that items that are found often move
+ *		towards the front.
  */
 
 # ifndef LIST_H
 # define LIST_H
 
+# define REORDER_NONE	0	/* leave items where they were added */
+# define REORDER_MTF	1	/* move found item to the front */
+# define REORDER_TRANSPOSE	2	/* swap found item with its predecessor */
+
 typedef struct list LIST;
 
 extern LIST *createList(int (*compare)());
@@ -39,4 +45,8 @@ extern void *findItem(LIST *lp, void *item);
 
 extern void *getItems(LIST *lp);
 
+extern void reorderList(LIST *lp, int policy);
+
+extern long numCompares(LIST *lp);
+
 # endif /* LIST_H */
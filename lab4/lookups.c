@@ -0,0 +1,181 @@
+/*
+ * File:	lookups.c
+ *
+ * Copyright:	2023, Vladimir Ceban
+ *
+ * Description:	This file contains the main function for measuring how the
+ *		reorder policies of the lists in the set change the cost
+ *		of a lookup.
+ *
+ *		The program takes a single file as a command line argument.
+ *		For each policy, all words in the file are inserted into a
+ *		set as in unique.c, and then every word in the file is
+ *		looked up again.  The average number of comparisons per
+ *		lookup in the second pass is printed, along with the
+ *		average number of comparisons per word when running the
+ *		parity.c workload with the same policy.
+ */
+
+# include <stdio.h>
+# include <stdlib.h>
+# include <string.h>
+# include "set.h"
+# include "list.h"
+
+
+/* This is sufficient for the test cases in /scratch/coen12. */
+
+# define MAX_SIZE 18000
+
+
+/*
+ * Function:	strhash
+ *
+ * Description:	Return a hash value for a string S.
+ */
+
+static unsigned strhash(char *s)
+{
+    unsigned hash = 0;
+
+
+    while (*s != '\0')
+	hash = 31 * hash + *s ++;
+
+    return hash;
+}
+
+
+/*
+ * Function:	destroyWords
+ *
+ * Description:	Free every word in the set and then the set itself.
+ */
+
+static void destroyWords(SET *sp)
+{
+    char **elts;
+    int i;
+
+
+    elts = getElements(sp);
+
+    for (i = 0; i < numElements(sp); i ++)
+	free(elts[i]);
+
+    free(elts);
+    destroySet(sp);
+}
+
+
+/*
+ * Function:	lookups
+ *
+ * Description:	Insert all words in the file into a set with the given
+ *		policy, then look every word up again and return the
+ *		average number of comparisons per lookup.
+ */
+
+static double lookups(FILE *fp, int policy)
+{
+    char buffer[BUFSIZ];
+    long before, words;
+    SET *sp;
+
+
+    sp = createSet(MAX_SIZE, strcmp, strhash);
+    reorderSet(sp, policy);
+    rewind(fp);
+
+    while (fscanf(fp, "%s", buffer) == 1)
+	if (!findElement(sp, buffer))
+	    addElement(sp, strdup(buffer));
+
+    words = 0;
+    before = numComparisons(sp);
+    rewind(fp);
+
+    while (fscanf(fp, "%s", buffer) == 1) {
+	words ++;
+	findElement(sp, buffer);
+    }
+
+    before = numComparisons(sp) - before;
+    destroyWords(sp);
+    return words > 0 ? (double) before / words : 0;
+}
+
+
+/*
+ * Function:	parity
+ *
+ * Description:	Run the parity.c workload with the given policy and
+ *		return the average number of comparisons per word.
+ */
+
+static double parity(FILE *fp, int policy)
+{
+    char buffer[BUFSIZ], *word;
+    long compares, words;
+    SET *sp;
+
+
+    sp = createSet(MAX_SIZE, strcmp, strhash);
+    reorderSet(sp, policy);
+    rewind(fp);
+    words = 0;
+
+    while (fscanf(fp, "%s", buffer) == 1) {
+	words ++;
+
+	if ((word = findElement(sp, buffer)) != NULL) {
+	    removeElement(sp, buffer);
+	    free(word);
+	} else
+	    addElement(sp, strdup(buffer));
+    }
+
+    compares = numComparisons(sp);
+    destroyWords(sp);
+    return words > 0 ? (double) compares / words : 0;
+}
+
+
+/*
+ * Function:	main
+ *
+ * Description:	Driver function for the test application.
+ */
+
+int main(int argc, char *argv[])
+{
+    FILE *fp;
+    int i;
+    int policies[] = {REORDER_NONE, REORDER_MTF, REORDER_TRANSPOSE};
+    char *names[] = {"none", "move-to-front", "transpose"};
+
+
+    /* Check usage and open the file. */
+
+    if (argc != 2) {
+	fprintf(stderr, "usage: %s file1\n", argv[0]);
+	exit(EXIT_FAILURE);
+    }
+
+    if ((fp = fopen(argv[1], "r")) == NULL) {
+	fprintf(stderr, "%s: cannot open %s\n", argv[0], argv[1]);
+	exit(EXIT_FAILURE);
+    }
+
+
+    /* Measure each policy. */
+
+    printf("%-14s %12s %12s\n", "policy", "per lookup", "per word");
+
+    for (i = 0; i < 3; i ++)
+	printf("%-14s %12.2f %12.2f\n", names[i], lookups(fp, policies[i]),
+		parity(fp, policies[i]));
+
+    fclose(fp);
+    exit(EXIT_SUCCESS);
+}
@@ -139,3 +139,30 @@ void *getElements(SET *sp) {
 
   return a;
 }
+
+// Set the reorder policy of every list in the set, see list.h
+// Big O = O(m), where m is the length of the set
+void reorderSet(SET *sp, int policy) {
+  assert(sp != NULL);
+
+  int i;
+  for (i = 0; i < sp->length; i++) {
+    reorderList(sp->list[i], policy);
+  }
+
+  return;
+}
+
+// Return the number of comparisons made by all lists in the set so far
+// Big O = O(m), where m is the length of the set
+long numComparisons(SET *sp) {
+  assert(sp != NULL);
+
+  long total = 0;
+  int i;
+  for (i = 0; i < sp->length; i++) {
+    total += numCompares(sp->list[i]);
+  }
+
+  return total;
+}
@@ -28,4 +28,8 @@ void *findElement(SET *sp, void *elt);
 
 void *getElements(SET *sp);
 
+void reorderSet(SET *sp, int policy);
+
+long numComparisons(SET *sp);
+
 # endif /* SET_H */
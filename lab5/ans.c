@@ -0,0 +1,479 @@
+/*
+ * File:	ans.c
+ *
+ * Copyright:	2023, Vladimir Ceban
+ *
+ * Description:	This file contains the functions declared in ans.h.  The
+ *		coder keeps a state between TABLE_SIZE and 2 * TABLE_SIZE.
+ *		The TABLE_SIZE slots of the table are spread among the
+ *		bytes in proportion to their frequencies, and coding a byte
+ *		shifts out the low bits of the state until it falls in the
+ *		range of that byte's frequency, then moves to one of its
+ *		slots.  Decoding reverses this: the slot gives the byte, how
+ *		many bits to shift back in, and what to add them to, with
+ *		no branches on the bits read.
+ *
+ *		Bytes are coded from last to first, so the bits are written
+ *		backwards from the end of the output, and the decoder reads
+ *		them forwards.  Byte i is coded by state i % NUM_STATES, and
+ *		the final states go last, so the decoder reads them first.
+ *		A one bit above them marks where the bits start.
+ *
+ *		See the comments for the functions below for a more
+ *		detailed description of each of them.
+ */
+
+# include <assert.h>
+# include <stdint.h>
+# include <stdlib.h>
+# include <string.h>
+# include "ans.h"
+# include "bitio.h"
+
+# define TABLE_SIZE (1 << ANS_TABLE_LOG)	/* slots, and sum of freqs */
+# define NUM_STATES 4			/* states taking turns at bytes */
+
+typedef struct symbol SYMBOL;
+
+struct symbol {
+    int deltaBits;		/* bits to shift are (x + deltaBits) >> 16 */
+    int deltaState;		/* next is table[(x >> bits) + deltaState] */
+};
+
+typedef struct slot SLOT;
+
+struct slot {
+    uint16_t next;		/* state before adding the bits read */
+    unsigned char symbol;	/* byte decoded */
+    unsigned char bits;		/* bits to read */
+};
+
+
+/*
+ * Function:	highBit
+ *
+ * Description:	Return the index of the highest bit set in X.
+ */
+
+static inline int highBit(unsigned x)
+{
+    return 31 - __builtin_clz(x);
+}
+
+
+/*
+ * Function:	normalizeCounts
+ *
+ * Description:	Scale the COUNTS of the N bytes to frequencies that add up
+ *		to TABLE_SIZE, giving every byte that appears at least one.
+ *		Each correction goes to the byte for which it costs the
+ *		fewest bits.
+ */
+
+void normalizeCounts(long counts[256], long n, int freqs[256])
+{
+    int c, best, total;
+
+
+    assert(counts != NULL && freqs != NULL && n > 0);
+    total = 0;
+
+    for (c = 0; c < 256; c ++) {
+	freqs[c] = 0;
+
+	if (counts[c] > 0) {
+	    freqs[c] = (counts[c] * TABLE_SIZE + n / 2) / n;
+	    freqs[c] = freqs[c] > 0 ? freqs[c] : 1;
+	}
+
+	total += freqs[c];
+    }
+
+
+    /* Taking one from a frequency f costs about count / f bits, and adding
+       one saves about as much. */
+
+    while (total > TABLE_SIZE) {
+	best = -1;
+
+	for (c = 0; c < 256; c ++)
+	    if (freqs[c] > 1 && (best < 0 || (double) counts[c] /
+		    (freqs[c] - 0.5) < (double) counts[best] /
+		    (freqs[best] - 0.5)))
+		best = c;
+
+	freqs[best] --;
+	total --;
+    }
+
+    while (total < TABLE_SIZE) {
+	best = -1;
+
+	for (c = 0; c < 256; c ++)
+	    if (freqs[c] > 0 && (best < 0 || (double) counts[c] /
+		    (freqs[c] + 0.5) > (double) counts[best] /
+		    (freqs[best] + 0.5)))
+		best = c;
+
+	freqs[best] ++;
+	total ++;
+    }
+}
+
+
+/*
+ * Function:	putFrequencies
+ *
+ * Description:	Store the frequencies in OUT, each in one byte if it is
+ *		below 128 or two bytes otherwise, and a run of zeros as a
+ *		zero and the number of zeros after it.  Return the number
+ *		of bytes stored.
+ */
+
+long putFrequencies(int freqs[256], unsigned char *out)
+{
+    int c, run;
+    long size;
+
+
+    assert(freqs != NULL && out != NULL);
+    size = 0;
+    c = 0;
+
+    while (c < 256) {
+	if (freqs[c] == 0) {
+	    for (run = 0; c + 1 + run < 256 && freqs[c + 1 + run] == 0; run ++)
+		;
+
+	    out[size ++] = 0;
+	    out[size ++] = run;
+	    c += 1 + run;
+
+	} else {
+	    if (freqs[c] >= 128)
+		out[size ++] = 128 | freqs[c] >> 7;
+
+	    out[size ++] = freqs[c] & 127;
+	    c ++;
+	}
+    }
+
+    return size;
+}
+
+
+/*
+ * Function:	getFrequencies
+ *
+ * Description:	Read the frequencies stored by putFrequencies from at most
+ *		SIZE bytes of IN.  Return the number of bytes read, or -1
+ *		if they are not valid or do not add up to TABLE_SIZE.
+ */
+
+long getFrequencies(unsigned char *in, long size, int freqs[256])
+{
+    int c, end, freq, total;
+    long i;
+
+
+    assert(in != NULL && freqs != NULL);
+    i = 0;
+    c = 0;
+    total = 0;
+
+    while (c < 256 && i < size) {
+	if (in[i] == 0) {
+	    if (i + 1 >= size || c + 1 + in[i + 1] > 256)
+		return -1;
+
+	    for (end = c + 1 + in[i + 1]; c < end; c ++)
+		freqs[c] = 0;
+
+	    i += 2;
+
+	} else {
+	    freq = in[i ++];
+
+	    if (freq >= 128) {
+		if (i >= size)
+		    return -1;
+
+		freq = (freq & 127) << 7 | in[i ++];
+	    }
+
+	    freqs[c ++] = freq;
+	    total += freq;
+	}
+    }
+
+    return c == 256 && total == TABLE_SIZE ? i : -1;
+}
+
+
+/*
+ * Function:	spread
+ *
+ * Description:	Spread the slots of the table among the bytes, so that the
+ *		slots of each byte are far apart.
+ */
+
+static void spread(int freqs[256], unsigned char symbols[TABLE_SIZE])
+{
+    int c, i, pos, step;
+
+
+    pos = 0;
+    step = (TABLE_SIZE >> 1) + (TABLE_SIZE >> 3) + 3;
+
+    for (c = 0; c < 256; c ++)
+	for (i = 0; i < freqs[c]; i ++) {
+	    symbols[pos] = c;
+	    pos = (pos + step) & (TABLE_SIZE - 1);
+	}
+}
+
+
+/*
+ * Function:	storeBack
+ *
+ * Description:	Store the oldest 32 of the bits gathered just before the
+ *		bytes already stored at P, unless that would go past the
+ *		start of OUT.  Return false if it would.
+ */
+
+static inline bool storeBack(uint64_t *bits, int *count, unsigned char **p,
+	unsigned char *out)
+{
+    if (*p - out < 4)
+	return false;
+
+    *p -= 4;
+    (*p)[0] = *bits >> 24;
+    (*p)[1] = *bits >> 16;
+    (*p)[2] = *bits >> 8;
+    (*p)[3] = *bits;
+
+    *bits >>= 32;
+    *count -= 32;
+    return true;
+}
+
+
+/*
+ * Function:	encodeANS
+ *
+ * Description:	Code the N bytes of IN into at most SIZE bytes of OUT.
+ *		Return the number of bytes used, or -1 if they do not fit.
+ */
+
+long encodeANS(unsigned char *in, long n, int freqs[256], unsigned char *out,
+	long size)
+{
+    unsigned char symbols[TABLE_SIZE], *p;
+    uint16_t table[TABLE_SIZE];
+    unsigned x, states[NUM_STATES];
+    int next[256], c, i, bits, shift, count, total;
+    SYMBOL codes[256], *sp;
+    uint64_t gathered;
+    long j, used;
+
+
+    assert(in != NULL && freqs != NULL && out != NULL && n >= 0);
+
+
+    /* The slots of each byte in order hold the states that coding it can
+       move to, starting after the slots of the bytes before it. */
+
+    total = 0;
+
+    for (c = 0; c < 256; c ++) {
+	next[c] = total;
+
+	if (freqs[c] > 0) {
+	    bits = ANS_TABLE_LOG - (freqs[c] > 1 ? highBit(freqs[c] - 1) : 0);
+	    codes[c].deltaBits = (bits << 16) - (freqs[c] << bits);
+	    codes[c].deltaState = total - freqs[c];
+	}
+
+	total += freqs[c];
+    }
+
+    spread(freqs, symbols);
+
+    for (i = 0; i < TABLE_SIZE; i ++)
+	table[next[symbols[i]] ++] = TABLE_SIZE + i;
+
+
+    /* Gather bits above the older ones, and store 32 of them at a time at
+       the end of what is left of the output, where the decoder reads them
+       last. */
+
+    gathered = 0;
+    count = 0;
+    p = out + size;
+
+    for (i = 0; i < NUM_STATES; i ++)
+	states[i] = TABLE_SIZE;
+
+    for (j = n - 1; j >= 0; j --) {
+	sp = &codes[in[j]];
+	x = states[j % NUM_STATES];
+	shift = (x + sp->deltaBits) >> 16;
+	gathered |= (uint64_t) (x & ((1 << shift) - 1)) << count;
+	count += shift;
+	states[j % NUM_STATES] = table[(x >> shift) + sp->deltaState];
+
+	if (count >= 32 && !storeBack(&gathered, &count, &p, out))
+	    return -1;
+    }
+
+
+    /* Then the final states, the last one first, and the marker bit. */
+
+    for (i = NUM_STATES - 1; i >= 0; i --) {
+	gathered |= (uint64_t) (states[i] - TABLE_SIZE) << count;
+	count += ANS_TABLE_LOG;
+
+	if (count >= 32 && !storeBack(&gathered, &count, &p, out))
+	    return -1;
+    }
+
+    gathered |= (uint64_t) 1 << count ++;
+
+    while (count > 0) {
+	if (p == out)
+	    return -1;
+
+	*-- p = gathered;
+	gathered >>= 8;
+	count -= 8;
+    }
+
+
+    /* Move the bits to the start of the output. */
+
+    used = out + size - p;
+    memmove(out, p, used);
+    return used;
+}
+
+
+/*
+ * Function:	takeBits
+ *
+ * Description:	Return the next N bits of the reader, which may be none,
+ *		and skip them.
+ */
+
+static inline unsigned takeBits(BITREADER *br, int n)
+{
+    unsigned value;
+
+
+    value = br->bits >> (63 - n) >> 1;
+    skipBits(br, n);
+    return value;
+}
+
+
+/*
+ * Function:	decodeANS
+ *
+ * Description:	Decode N bytes into OUT from SIZE bytes of coded input.
+ *		Return false if the input is corrupted.
+ */
+
+bool decodeANS(unsigned char *in, long size, int freqs[256],
+	unsigned char *out, long n)
+{
+    unsigned char symbols[TABLE_SIZE];
+    unsigned s0, s1, s2, s3, *states[NUM_STATES];
+    int next[256], c, i, x;
+    SLOT *table, *sp;
+    BITREADER br;
+    long j;
+
+
+    assert(in != NULL && freqs != NULL && (out != NULL || n == 0) && n >= 0);
+    table = malloc(sizeof(SLOT) * TABLE_SIZE);
+    assert(table != NULL);
+
+
+    /* Slot i holds the state x that coding its byte left in the range of
+       its frequency, so decoding it shifts x back up to at least
+       TABLE_SIZE. */
+
+    for (c = 0; c < 256; c ++)
+	next[c] = freqs[c];
+
+    spread(freqs, symbols);
+
+    for (i = 0; i < TABLE_SIZE; i ++) {
+	x = next[symbols[i]] ++;
+	table[i].symbol = symbols[i];
+	table[i].bits = ANS_TABLE_LOG - highBit(x);
+	table[i].next = (x << table[i].bits) - TABLE_SIZE;
+    }
+
+
+    /* Skip the zeros above the marker bit, which is in the first byte. */
+
+    initReader(&br, in, size);
+    refillBits(&br);
+
+    if (size == 0 || peekBits(&br, 8) == 0) {
+	free(table);
+	return false;
+    }
+
+    skipBits(&br, __builtin_clzll(br.bits) + 1);
+
+    refillBits(&br);
+    s0 = takeBits(&br, ANS_TABLE_LOG);
+    s1 = takeBits(&br, ANS_TABLE_LOG);
+    s2 = takeBits(&br, ANS_TABLE_LOG);
+    s3 = takeBits(&br, ANS_TABLE_LOG);
+
+
+    /* A refill leaves enough bits for one byte from each state. */
+
+    for (j = 0; n - j >= NUM_STATES; j += NUM_STATES) {
+	refillBits(&br);
+
+	sp = &table[s0];
+	out[j] = sp->symbol;
+	s0 = sp->next + takeBits(&br, sp->bits);
+
+	sp = &table[s1];
+	out[j + 1] = sp->symbol;
+	s1 = sp->next + takeBits(&br, sp->bits);
+
+	sp = &table[s2];
+	out[j + 2] = sp->symbol;
+	s2 = sp->next + takeBits(&br, sp->bits);
+
+	sp = &table[s3];
+	out[j + 3] = sp->symbol;
+	s3 = sp->next + takeBits(&br, sp->bits);
+    }
+
+    refillBits(&br);
+    states[0] = &s0;
+    states[1] = &s1;
+    states[2] = &s2;
+    states[3] = &s3;
+
+    for (i = 0; j < n; i ++, j ++) {
+	sp = &table[*states[i]];
+	out[j] = sp->symbol;
+	*states[i] = sp->next + takeBits(&br, sp->bits);
+    }
+
+
+    /* Every state must be back where the coder started, with all bits
+       read. */
+
+    free(table);
+    return s0 == 0 && s1 == 0 && s2 == 0 && s3 == 0 && br.next == br.end &&
+	br.count == br.padded;
+}
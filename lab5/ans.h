@@ -0,0 +1,47 @@
+/*
+ * File:	ans.h
+ *
+ * Copyright:	2023, Vladimir Ceban
+ *
+ * Description:	This file contains the public function declarations for a
+ *		table-driven asymmetric numeral system (tANS) coder of
+ *		bytes.  Unlike a Huffman code, it can spend a fraction of a
+ *		bit on a byte, so it comes closer to the entropy when some
+ *		bytes are very common.  The counts of the bytes are first
+ *		scaled by normalizeCounts to frequencies that add up to
+ *		1 << ANS_TABLE_LOG, every byte that appears getting at least
+ *		one.  putFrequencies stores them in OUT and returns the
+ *		number of bytes used, at most FREQUENCY_BOUND, and
+ *		getFrequencies reads them back from at most SIZE bytes and
+ *		returns the number of bytes read, or -1 if they are not
+ *		valid.
+ *
+ *		encodeANS codes N bytes with the given frequencies into at
+ *		most SIZE bytes of OUT and returns the number of bytes
+ *		used, or -1 if they do not fit.  decodeANS decodes N bytes
+ *		from SIZE bytes of coded input, and returns false if it is
+ *		corrupted.  Four states take turns at the bytes, so the
+ *		decoder can work on four of them at once.
+ */
+
+# ifndef ANS_H
+# define ANS_H
+
+# include <stdbool.h>
+
+# define ANS_TABLE_LOG 12
+# define FREQUENCY_BOUND 512
+
+void normalizeCounts(long counts[256], long n, int freqs[256]);
+
+long putFrequencies(int freqs[256], unsigned char *out);
+
+long getFrequencies(unsigned char *in, long size, int freqs[256]);
+
+long encodeANS(unsigned char *in, long n, int freqs[256], unsigned char *out,
+	long size);
+
+bool decodeANS(unsigned char *in, long size, int freqs[256],
+	unsigned char *out, long n);
+
+# endif /* ANS_H */
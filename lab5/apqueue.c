@@ -0,0 +1,185 @@
+/*
+ * File: apqueue.c
+ *
+ * Copyright:	2023, Vladimir Ceban
+ *
+ * Description: This file contains functions defined in apqueue.h. The queue
+ * is a binary heap like pqueue.c, but the array holds handles instead of
+ * entries, and every handle remembers its index in the array. Whenever heap
+ * up or heap down moves a handle, it updates that index, so the position of
+ * any entry is known in O(1) and its key can be changed in O(log n) without
+ * adding a second copy of it to the queue.
+ *
+ */
+
+#include "apqueue.h"
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+// Defines handle type, one per entry in the queue
+typedef struct handle {
+  void *entry;
+  int index; // position of this handle in the heap array
+} HANDLE;
+
+// Defines addressable priority queue type
+typedef struct apqueue {
+  int count;
+  int length;
+  HANDLE **data;
+  int (*compare)(void *, void *);
+} APQ;
+
+// Moves handle up from index this and stores it where it belongs.
+// Big O complexity: O(log n)
+static void heapUp(APQ *apq, int this, HANDLE *hp) {
+  int parent = (this - 1) / 2;
+
+  // move parents down into the hole while the handle's entry is smaller
+  while (this > 0 && apq->compare(hp->entry, apq->data[parent]->entry) < 0) {
+    apq->data[this] = apq->data[parent];
+    apq->data[this]->index = this;
+
+    this = parent;
+    parent = (this - 1) / 2;
+  }
+
+  apq->data[this] = hp;
+  hp->index = this;
+}
+
+// Moves handle down from index this and stores it where it belongs.
+// Big O complexity: O(log n)
+static void heapDown(APQ *apq, int this, HANDLE *hp) {
+  int left = 2 * this + 1;
+
+  while (left < apq->count) {
+    // pick the smaller child
+    int min = left;
+    if (left + 1 < apq->count &&
+        apq->compare(apq->data[left + 1]->entry, apq->data[left]->entry) < 0) {
+      min = left + 1;
+    }
+
+    // move it up into the hole if the handle's entry is larger
+    if (apq->compare(hp->entry, apq->data[min]->entry) <= 0) {
+      break;
+    }
+    apq->data[this] = apq->data[min];
+    apq->data[this]->index = this;
+
+    this = min;
+    left = 2 * this + 1;
+  }
+
+  apq->data[this] = hp;
+  hp->index = this;
+}
+
+// Creates addressable priority queue and returns pointer to it.
+// Big O complexity: O(1)
+APQ *createAPQ(int (*compare)()) {
+  assert(compare != NULL);
+
+  APQ *apq = malloc(sizeof(APQ));
+  assert(apq != NULL);
+
+  apq->count = 0;
+  apq->length = 10; // will grow if needed
+  apq->compare = compare;
+  apq->data = malloc(apq->length * sizeof(HANDLE *));
+  assert(apq->data != NULL);
+
+  return apq;
+}
+
+// Destroys queue and the handles still in it, entries are not freed.
+// Big O complexity: O(n)
+void destroyAPQ(APQ *apq) {
+  assert(apq != NULL);
+
+  int i;
+  for (i = 0; i < apq->count; i++) {
+    free(apq->data[i]);
+  }
+
+  free(apq->data);
+  free(apq);
+}
+
+// Returns number of entries in the queue. Big O complexity: O(1)
+int numAPQEntries(APQ *apq) {
+  assert(apq != NULL);
+  return apq->count;
+}
+
+// Adds a new entry and returns its handle. Big O complexity: O(log n)
+HANDLE *addAPQEntry(APQ *apq, void *entry) {
+  assert(apq != NULL && entry != NULL);
+
+  // double the size of array if needed
+  if (apq->count == apq->length) {
+    apq->length *= 2;
+    apq->data = realloc(apq->data, apq->length * sizeof(HANDLE *));
+    assert(apq->data != NULL);
+  }
+
+  HANDLE *hp = malloc(sizeof(HANDLE));
+  assert(hp != NULL);
+  hp->entry = entry;
+
+  apq->count++;
+  heapUp(apq, apq->count - 1, hp);
+
+  return hp;
+}
+
+// Removes the smallest entry and returns it, its handle is freed.
+// Big O complexity: O(log n)
+void *removeAPQEntry(APQ *apq) {
+  assert(apq != NULL && apq->count > 0);
+  return removeHandle(apq, apq->data[0]);
+}
+
+// Returns the entry a handle refers to. Big O complexity: O(1)
+void *getHandleEntry(HANDLE *hp) {
+  assert(hp != NULL);
+  return hp->entry;
+}
+
+// Restores the queue after the key of hp's entry was made smaller.
+// Big O complexity: O(log n)
+void decreaseKey(APQ *apq, HANDLE *hp) {
+  assert(apq != NULL && hp != NULL && apq->data[hp->index] == hp);
+  heapUp(apq, hp->index, hp);
+}
+
+// Restores the queue after the key of hp's entry was made larger.
+// Big O complexity: O(log n)
+void increaseKey(APQ *apq, HANDLE *hp) {
+  assert(apq != NULL && hp != NULL && apq->data[hp->index] == hp);
+  heapDown(apq, hp->index, hp);
+}
+
+// Removes any entry through its handle and returns it, the handle is freed.
+// Big O complexity: O(log n)
+void *removeHandle(APQ *apq, HANDLE *hp) {
+  assert(apq != NULL && hp != NULL && apq->data[hp->index] == hp);
+
+  void *entry = hp->entry;
+  int this = hp->index;
+  free(hp);
+
+  // the last handle fills the hole, then moves whichever way it has to
+  apq->count--;
+  if (this < apq->count) {
+    HANDLE *last = apq->data[apq->count];
+    heapUp(apq, this, last);
+    if (last->index == this) {
+      heapDown(apq, this, last);
+    }
+  }
+
+  return entry;
+}
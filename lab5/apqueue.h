@@ -0,0 +1,41 @@
+/*
+ * File:	apqueue.h
+ *
+ * Copyright:	2023, Vladimir Ceban
+ *
+ * Description:	This file contains the public function and type
+ *		declarations for an addressable priority queue abstract
+ *		data type for generic pointer types.  Adding an entry
+ *		returns a handle to it.  After changing the key of an
+ *		entry in place, the caller passes its handle to
+ *		decreaseKey or increaseKey to restore the queue, and any
+ *		entry can be removed through its handle.  A handle is
+ *		valid until its entry is removed or the queue destroyed.
+ */
+
+# ifndef APQUEUE_H
+# define APQUEUE_H
+
+typedef struct apqueue APQ;
+
+typedef struct handle HANDLE;
+
+APQ *createAPQ(int (*compare)());
+
+void destroyAPQ(APQ *apq);
+
+int numAPQEntries(APQ *apq);
+
+HANDLE *addAPQEntry(APQ *apq, void *entry);
+
+void *removeAPQEntry(APQ *apq);
+
+void *getHandleEntry(HANDLE *hp);
+
+void decreaseKey(APQ *apq, HANDLE *hp);
+
+void increaseKey(APQ *apq, HANDLE *hp);
+
+void *removeHandle(APQ *apq, HANDLE *hp);
+
+# endif /* APQUEUE_H */
@@ -0,0 +1,163 @@
+/*
+ * File:	bitio.h
+ *
+ * Copyright:	2023, Vladimir Ceban
+ *
+ * Description:	This file contains a reader and a writer for strings of
+ *		bits with the most significant bit of each byte first, as
+ *		used by pack.c.  The reader keeps up to 64 bits in a
+ *		register with the next bit on top, and refills it eight
+ *		bytes at a time, so that most reads cost a shift and no
+ *		memory access:
+ *
+ *		void initReader(BITREADER *br, unsigned char *buf, long n);
+ *		void refillBits(BITREADER *br);
+ *		unsigned peekBits(BITREADER *br, int n);
+ *		void skipBits(BITREADER *br, int n);
+ *		bool overrun(BITREADER *br);
+ *
+ *		After refillBits at least 56 bits can be peeked and
+ *		skipped.  Past the end of the buffer the reader returns
+ *		zero bits, and overrun tells whether any of them were
+ *		skipped.
+ *
+ *		The writer gathers bits in a register the same way and
+ *		stores eight bytes at a time into a buffer given by the
+ *		caller, which must be at least 16 bytes long.  The full
+ *		part of the buffer is written to a file whenever fewer
+ *		than eight bytes are free:
+ *
+ *		void initWriter(BITWRITER *bw, unsigned char *buf, long n,
+ *			FILE *fp);
+ *		void putBits(BITWRITER *bw, unsigned long code, int n);
+ *		void flushBits(BITWRITER *bw);
+ *
+ *		Up to 25 bits may be put at once.  flushBits pads the last
+ *		byte with zero bits and writes everything out.  With a
+ *		null file, the bits stay in the buffer, which must then
+ *		have room for all of them plus eight bytes, and NEXT is
+ *		left just past the last byte.
+ */
+
+# ifndef BITIO_H
+# define BITIO_H
+
+# include <stdio.h>
+# include <stdint.h>
+# include <string.h>
+# include <stdbool.h>
+
+typedef struct bitreader {
+    uint64_t bits;		/* next bit is the top bit */
+    int count;			/* number of bits in BITS */
+    int padded;			/* number of those past the end */
+    unsigned char *next;	/* next byte not yet in BITS */
+    unsigned char *end;
+} BITREADER;
+
+static inline void initReader(BITREADER *br, unsigned char *buf, long n)
+{
+    br->bits = 0;
+    br->count = 0;
+    br->padded = 0;
+    br->next = buf;
+    br->end = buf + n;
+}
+
+static inline void refillBits(BITREADER *br)
+{
+    uint64_t word;
+
+
+    /* Load eight bytes at once and keep whole bytes of them. */
+
+    if (br->end - br->next >= 8) {
+	memcpy(&word, br->next, sizeof(word));
+	br->bits |= __builtin_bswap64(word) >> br->count;
+	br->next += (63 - br->count) >> 3;
+	br->count |= 56;
+	return;
+    }
+
+    while (br->count <= 56) {
+	if (br->next < br->end)
+	    br->bits |= (uint64_t) *br->next ++ << (56 - br->count);
+	else
+	    br->padded += 8;
+
+	br->count += 8;
+    }
+}
+
+static inline unsigned peekBits(BITREADER *br, int n)
+{
+    return br->bits >> (64 - n);
+}
+
+static inline void skipBits(BITREADER *br, int n)
+{
+    br->bits <<= n;
+    br->count -= n;
+}
+
+static inline bool overrun(BITREADER *br)
+{
+    return br->count < br->padded;
+}
+
+typedef struct bitwriter {
+    uint64_t bits;		/* next bit to store is the top bit */
+    int count;			/* number of bits in BITS */
+    unsigned char *next;	/* next byte of the buffer to store */
+    unsigned char *buf;
+    unsigned char *end;
+    FILE *fp;
+} BITWRITER;
+
+static inline void initWriter(BITWRITER *bw, unsigned char *buf, long n,
+	FILE *fp)
+{
+    bw->bits = 0;
+    bw->count = 0;
+    bw->next = bw->buf = buf;
+    bw->end = buf + n;
+    bw->fp = fp;
+}
+
+static inline void putBits(BITWRITER *bw, unsigned long code, int n)
+{
+    uint64_t word;
+
+
+    bw->bits |= (uint64_t) code << (64 - bw->count - n);
+    bw->count += n;
+
+    /* Store eight bytes at once and keep the bits of the partial byte. */
+
+    word = __builtin_bswap64(bw->bits);
+    memcpy(bw->next, &word, sizeof(word));
+    bw->next += bw->count >> 3;
+    bw->bits <<= bw->count & ~7;
+    bw->count &= 7;
+
+    if (bw->fp != NULL && bw->end - bw->next < 8) {
+	fwrite(bw->buf, 1, bw->next - bw->buf, bw->fp);
+	bw->next = bw->buf;
+    }
+}
+
+static inline void flushBits(BITWRITER *bw)
+{
+    if (bw->count > 0)
+	*bw->next ++ = bw->bits >> 56;
+
+    bw->bits = 0;
+    bw->count = 0;
+
+    if (bw->fp != NULL) {
+	fwrite(bw->buf, 1, bw->next - bw->buf, bw->fp);
+	bw->next = bw->buf;
+    }
+}
+
+# endif /* BITIO_H */
@@ -0,0 +1,489 @@
+/*
+ * File: block.c
+ *
+ * Copyright:	2023, Vladimir Ceban
+ *
+ * Description: This file contains functions defined in block.h. Each block is
+ * counted, coded and written before the next one is read, so compressing and
+ * decompressing both take one pass and memory for a couple of blocks, no
+ * matter how large the input is. Giving each block its own code also lets the
+ * code follow the input when its statistics change along the way, at a cost
+ * of 128 bytes per block for the table of code lengths.
+ *
+ */
+
+#include "block.h"
+#include "ans.h"
+#include "bitio.h"
+#include "codes.h"
+#include "decode.h"
+#include "histogram.h"
+#include <assert.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Size of the table of code lengths, four bits for each byte
+#define TABLE_SIZE 128
+
+// Size of the fields before the data in each type of block
+#define RAW_HEADER (1 + 4)
+#define HUFFMAN_HEADER (1 + 4 + TABLE_SIZE + 4)
+#define INTERLEAVED_HEADER (HUFFMAN_HEADER + 4 * (BLOCK_STREAMS - 1))
+#define ANS_HEADER (1 + 4 + 4)
+
+// Stores n in four bytes, most significant first. Big O complexity: O(1)
+static void putSize(unsigned char *p, unsigned long n) {
+  p[0] = n >> 24;
+  p[1] = n >> 16;
+  p[2] = n >> 8;
+  p[3] = n;
+}
+
+// Returns the number stored in four bytes by putSize. Big O complexity: O(1)
+static unsigned long getSize(unsigned char *p) {
+  return (unsigned long)p[0] << 24 | p[1] << 16 | p[2] << 8 | p[3];
+}
+
+// Stores a Huffman block for the n bytes of in with the codes split among the
+// given number of streams, or a raw block if that is not larger, and returns
+// its size. Big O complexity: O(n)
+static long encodeCodes(unsigned char *in, long n, unsigned char *out,
+                        int streams) {
+  assert((in != NULL || n == 0) && out != NULL && n >= 0 && n <= BLOCK_SIZE);
+
+  long counts[256] = {0};
+  long header = streams == 1 ? HUFFMAN_HEADER : INTERLEAVED_HEADER;
+  int lengths[256];
+  int c, s;
+  countBytes(in, n, counts);
+
+  // use a Huffman block only if it is smaller than a raw block, limiting the
+  // codes to what fits in the table if the best ones are too long
+  if (n > 0) {
+    if (!huffmanLengths(counts, 256, lengths, MAX_BLOCK_CODE)) {
+      limitedLengths(counts, 256, lengths, MAX_BLOCK_CODE);
+    }
+
+    long bits = 0;
+    for (c = 0; c < 256; c++) {
+      bits += counts[c] * lengths[c];
+    }
+
+    // every stream after the first may need one more byte for its last bits
+    long size = (bits + 7) / 8 + streams - 1;
+    if (header + size < RAW_HEADER + n) {
+      unsigned long codes[256];
+      canonicalCodes(lengths, 256, codes);
+
+      out[0] = streams == 1 ? BLOCK_HUFFMAN : BLOCK_INTERLEAVED;
+      putSize(out + 1, n);
+      for (c = 0; c < 256; c += 2) {
+        out[5 + c / 2] = lengths[c] << 4 | lengths[c + 1];
+      }
+
+      // the first streams code a share of the bytes each and the last one
+      // the rest, and the size of each but the last goes after the table. The
+      // writer may store up to eight bytes past the last code
+      unsigned char *p = out + header;
+      long i = 0, share = n / streams;
+      for (s = 0; s < streams; s++) {
+        long end = s < streams - 1 ? i + share : n;
+        BITWRITER bw;
+        initWriter(&bw, p, out + header + size + 8 - p, NULL);
+        for (; i < end; i++) {
+          putBits(&bw, codes[in[i]], lengths[in[i]]);
+        }
+        flushBits(&bw);
+        if (s < streams - 1) {
+          putSize(out + 5 + TABLE_SIZE + 4 * s, bw.next - p);
+        }
+        p = bw.next;
+      }
+      putSize(out + header - 4, p - out - header);
+
+      return p - out;
+    }
+  }
+
+  out[0] = BLOCK_RAW;
+  putSize(out + 1, n);
+  memcpy(out + RAW_HEADER, in, n);
+  return RAW_HEADER + n;
+}
+
+// Stores a block for the n bytes of in, and returns its size.
+// Big O complexity: O(n)
+long encodeBlock(unsigned char *in, long n, unsigned char *out) {
+  return encodeCodes(in, n, out, 1);
+}
+
+// Stores a block for the n bytes of in with its codes split among
+// BLOCK_STREAMS streams, and returns its size. Big O complexity: O(n)
+long encodeInterleaved(unsigned char *in, long n, unsigned char *out) {
+  return encodeCodes(in, n, out, BLOCK_STREAMS);
+}
+
+// Stores an ANS block for the n bytes of in, or a raw block if that is not
+// larger, and returns its size. Big O complexity: O(n)
+long encodeANSBlock(unsigned char *in, long n, unsigned char *out) {
+  assert((in != NULL || n == 0) && out != NULL && n >= 0 && n <= BLOCK_SIZE);
+
+  // the frequencies go first, then the coded bytes, which must leave the
+  // block smaller than a raw one
+  if (n > 0) {
+    long counts[256] = {0};
+    int freqs[256];
+    unsigned char table[FREQUENCY_BOUND];
+    countBytes(in, n, counts);
+    normalizeCounts(counts, n, freqs);
+    long header = ANS_HEADER + putFrequencies(freqs, table);
+
+    if (header < RAW_HEADER + n) {
+      long size = encodeANS(in, n, freqs, out + header,
+                            RAW_HEADER + n - header - 1);
+      if (size >= 0) {
+        out[0] = BLOCK_ANS;
+        putSize(out + 1, n);
+        putSize(out + 5, header - ANS_HEADER + size);
+        memcpy(out + ANS_HEADER, table, header - ANS_HEADER);
+        return header + size;
+      }
+    }
+  }
+
+  out[0] = BLOCK_RAW;
+  putSize(out + 1, n);
+  memcpy(out + RAW_HEADER, in, n);
+  return RAW_HEADER + n;
+}
+
+// Reads one block from a file into block and returns its size, or -1 if the
+// file ends first or the block is too large. Big O complexity: O(n), where n
+// is the size of the block
+long readBlock(FILE *fp, unsigned char *block) {
+  assert(fp != NULL && block != NULL);
+
+  int type = getc(fp);
+  long header;
+
+  if (type == BLOCK_END) {
+    block[0] = type;
+    return 1;
+  } else if (type == BLOCK_RAW) {
+    header = RAW_HEADER;
+  } else if (type == BLOCK_HUFFMAN) {
+    header = HUFFMAN_HEADER;
+  } else if (type == BLOCK_INTERLEAVED) {
+    header = INTERLEAVED_HEADER;
+  } else if (type == BLOCK_ANS) {
+    header = ANS_HEADER;
+  } else {
+    return -1;
+  }
+
+  // the size of the data is in the last four bytes of the header
+  block[0] = type;
+  if (fread(block + 1, 1, header - 1, fp) != header - 1) {
+    return -1;
+  }
+
+  long size = getSize(block + header - 4);
+  if (header + size > BLOCK_BOUND(BLOCK_SIZE) ||
+      fread(block + header, 1, size, fp) != size) {
+    return -1;
+  }
+
+  return header + size;
+}
+
+// Decodes a block of the given size into out, and returns the number of bytes
+// decoded, or -1 if the block is corrupted. Big O complexity: O(n), where n is
+// the number of bytes decoded
+long decodeBlock(unsigned char *block, long size, unsigned char *out) {
+  assert(block != NULL && out != NULL && size > 0);
+
+  long n = size >= RAW_HEADER ? getSize(block + 1) : 0;
+  if (n > BLOCK_SIZE) {
+    return -1;
+  }
+
+  if (block[0] == BLOCK_END) {
+    return size == 1 ? 0 : -1;
+
+  } else if (block[0] == BLOCK_RAW) {
+    if (size != RAW_HEADER + n) {
+      return -1;
+    }
+    memcpy(out, block + RAW_HEADER, n);
+    return n;
+
+  } else if (block[0] == BLOCK_HUFFMAN || block[0] == BLOCK_INTERLEAVED) {
+    int streams = block[0] == BLOCK_HUFFMAN ? 1 : BLOCK_STREAMS;
+    long header = streams == 1 ? HUFFMAN_HEADER : INTERLEAVED_HEADER;
+    if (size < header || size != header + getSize(block + header - 4)) {
+      return -1;
+    }
+
+    // the last stream takes what the others leave
+    long sizes[BLOCK_STREAMS], rest = size - header;
+    int s;
+    for (s = 0; s < streams - 1; s++) {
+      sizes[s] = getSize(block + 5 + TABLE_SIZE + 4 * s);
+      if (sizes[s] > rest) {
+        return -1;
+      }
+      rest -= sizes[s];
+    }
+    sizes[streams - 1] = rest;
+
+    // the stream has no end of file symbol
+    int lengths[END_SYMBOL + 1];
+    int c;
+    for (c = 0; c < 256; c += 2) {
+      lengths[c] = block[5 + c / 2] >> 4;
+      lengths[c + 1] = block[5 + c / 2] & 0xf;
+    }
+    lengths[END_SYMBOL] = 0;
+
+    DECODER *dp = createDecoder(lengths);
+    if (dp == NULL) {
+      return -1;
+    }
+
+    BITREADER br[BLOCK_STREAMS];
+    unsigned char *p = block + header;
+    for (s = 0; s < streams; s++) {
+      initReader(&br[s], p, sizes[s]);
+      p += sizes[s];
+    }
+
+    if (streams == 1) {
+      decodeSymbols(dp, &br[0], out, n);
+    } else {
+      decodeStreams(dp, br, out, n);
+    }
+    destroyDecoder(dp);
+
+    for (s = 0; s < streams; s++) {
+      if (overrun(&br[s])) {
+        return -1;
+      }
+    }
+    return n;
+
+  } else if (block[0] == BLOCK_ANS) {
+    if (size < ANS_HEADER || size != ANS_HEADER + getSize(block + 5)) {
+      return -1;
+    }
+
+    int freqs[256];
+    long table = getFrequencies(block + ANS_HEADER, size - ANS_HEADER, freqs);
+    if (table < 0) {
+      return -1;
+    }
+
+    long header = ANS_HEADER + table;
+    return decodeANS(block + header, size - header, freqs, out, n) ? n : -1;
+  }
+
+  return -1;
+}
+
+// A block in the reorder buffer, holding the input read for it and the output
+// made from it, which is written once it is done and all blocks before it
+// have been written
+typedef struct slot {
+  unsigned char *in, *out;
+  long n, size;
+  bool done;
+} SLOT;
+
+// Work shared by the reading thread and the workers. Blocks are numbered in
+// the order they are read, and block i uses slot i % length
+typedef struct pipeline {
+  long (*job)(unsigned char *in, long n, unsigned char *out);
+  pthread_mutex_t lock;
+  pthread_cond_t ready, done;
+  SLOT *slots;
+  int length;
+  long read, next; // blocks read so far, and the next one to be worked on
+  bool end;
+} PIPELINE;
+
+// Takes blocks that have been read in order, and works on them until the
+// input ends. Big O complexity: O(n), where n is the size of the blocks
+static void *worker(void *arg) {
+  PIPELINE *pp = arg;
+  pthread_mutex_lock(&pp->lock);
+  while (true) {
+    while (pp->next == pp->read && !pp->end) {
+      pthread_cond_wait(&pp->ready, &pp->lock);
+    }
+    if (pp->next == pp->read) {
+      break;
+    }
+
+    SLOT *sp = &pp->slots[pp->next++ % pp->length];
+    pthread_mutex_unlock(&pp->lock);
+    long size = pp->job(sp->in, sp->n, sp->out);
+    pthread_mutex_lock(&pp->lock);
+
+    sp->size = size;
+    sp->done = true;
+    pthread_cond_broadcast(&pp->done);
+  }
+  pthread_mutex_unlock(&pp->lock);
+  return NULL;
+}
+
+// Reads blocks with input until it returns 0 at the end or -1 on an error,
+// does the job on each and writes the results in order. With more than one
+// thread, the jobs are done by a pool of workers while this thread reads and
+// writes, keeping up to two blocks per worker in a reorder buffer. Returns
+// false if reading, a job, or writing fails. Big O complexity: O(n), where n
+// is the size of the input
+static bool runPipeline(FILE *in, FILE *out, int threads,
+                        long (*input)(FILE *fp, unsigned char *buf),
+                        long (*job)(unsigned char *in, long n,
+                                    unsigned char *out)) {
+  assert(threads >= 1 && threads <= MAX_THREADS);
+
+  PIPELINE p = {job};
+  p.length = threads > 1 ? 2 * threads : 1;
+  p.slots = malloc(sizeof(SLOT) * p.length);
+  assert(p.slots != NULL);
+
+  int i;
+  for (i = 0; i < p.length; i++) {
+    p.slots[i].in = malloc(BLOCK_BOUND(BLOCK_SIZE));
+    p.slots[i].out = malloc(BLOCK_BOUND(BLOCK_SIZE));
+    p.slots[i].done = false;
+    assert(p.slots[i].in != NULL && p.slots[i].out != NULL);
+  }
+
+  bool ok = true;
+  long n, size;
+
+  // one thread needs no workers
+  if (threads == 1) {
+    SLOT *sp = &p.slots[0];
+    while ((n = input(in, sp->in)) > 0) {
+      if ((size = job(sp->in, n, sp->out)) < 0) {
+        break;
+      }
+      if (fwrite(sp->out, 1, size, out) != size) {
+        n = -1;
+        break;
+      }
+    }
+    ok = n == 0;
+
+  } else {
+    pthread_t workers[MAX_THREADS];
+    pthread_mutex_init(&p.lock, NULL);
+    pthread_cond_init(&p.ready, NULL);
+    pthread_cond_init(&p.done, NULL);
+    for (i = 0; i < threads; i++) {
+      pthread_create(&workers[i], NULL, worker, &p);
+    }
+
+    // read while there is room in the buffer, otherwise write the oldest
+    // block once it is done
+    long written = 0;
+    while (!p.end || written < p.read) {
+      if (!p.end && p.read - written < p.length) {
+        SLOT *sp = &p.slots[p.read % p.length];
+        n = input(in, sp->in);
+        pthread_mutex_lock(&p.lock);
+        if (n > 0) {
+          sp->n = n;
+          p.read++;
+          pthread_cond_signal(&p.ready);
+        } else {
+          ok = n == 0;
+          p.end = true;
+          pthread_cond_broadcast(&p.ready);
+        }
+        pthread_mutex_unlock(&p.lock);
+
+      } else {
+        SLOT *sp = &p.slots[written % p.length];
+        pthread_mutex_lock(&p.lock);
+        while (!sp->done) {
+          pthread_cond_wait(&p.done, &p.lock);
+        }
+        pthread_mutex_unlock(&p.lock);
+
+        if (sp->size < 0 || fwrite(sp->out, 1, sp->size, out) != sp->size) {
+          ok = false;
+          break;
+        }
+        sp->done = false;
+        written++;
+      }
+    }
+
+    // stop the workers, which finish the blocks they have already taken
+    pthread_mutex_lock(&p.lock);
+    p.end = true;
+    pthread_cond_broadcast(&p.ready);
+    pthread_mutex_unlock(&p.lock);
+    for (i = 0; i < threads; i++) {
+      pthread_join(workers[i], NULL);
+    }
+
+    pthread_mutex_destroy(&p.lock);
+    pthread_cond_destroy(&p.ready);
+    pthread_cond_destroy(&p.done);
+  }
+
+  for (i = 0; i < p.length; i++) {
+    free(p.slots[i].in);
+    free(p.slots[i].out);
+  }
+  free(p.slots);
+  return ok;
+}
+
+// Reads the next block of input to compress, returning -1 if reading fails.
+// Big O complexity: O(n), where n is the size of the block
+static long readData(FILE *fp, unsigned char *data) {
+  // fread only comes up short at the end of the file, even on a pipe
+  long n = fread(data, 1, BLOCK_SIZE, fp);
+  return n == 0 && ferror(fp) ? -1 : n;
+}
+
+// Reads the next block of a stream, returning 0 at the end block.
+// Big O complexity: O(n), where n is the size of the block
+static long readNext(FILE *fp, unsigned char *block) {
+  long size = readBlock(fp, block);
+  return size > 0 && block[0] == BLOCK_END ? 0 : size;
+}
+
+// Compresses a file into a stream of blocks of the given type in one pass,
+// using the given number of threads. Returns false if reading or writing
+// fails. Big O complexity: O(n), where n is the size of the file
+bool compressStream(FILE *in, FILE *out, int threads, int type) {
+  assert(in != NULL && out != NULL);
+
+  putc(037, out);
+  putc(STREAM_MAGIC, out);
+
+  assert(type == BLOCK_HUFFMAN || type == BLOCK_INTERLEAVED ||
+         type == BLOCK_ANS);
+  bool ok = runPipeline(in, out, threads, readData,
+                        type == BLOCK_ANS           ? encodeANSBlock
+                        : type == BLOCK_INTERLEAVED ? encodeInterleaved
+                                                    : encodeBlock);
+  return ok && putc(BLOCK_END, out) != EOF && !ferror(out);
+}
+
+// Decompresses a stream whose first two bytes have been read in one pass,
+// using the given number of threads. Returns false if it is corrupted.
+// Big O complexity: O(n), where n is the size of the stream
+bool decompressStream(FILE *in, FILE *out, int threads) {
+  assert(in != NULL && out != NULL);
+
+  return runPipeline(in, out, threads, readNext, decodeBlock);
+}
@@ -0,0 +1,89 @@
+/*
+ * File:	block.h
+ *
+ * Copyright:	2023, Vladimir Ceban
+ *
+ * Description:	This file contains the public function declarations and
+ *		definitions for a streaming Huffman format.  Unlike the
+ *		format of pack.c, it needs neither the size of the input
+ *		nor a second pass over it, so it works on pipes, and it has
+ *		no limit on the size of the input.
+ *
+ *		A stream starts with 037 035 and is followed by blocks of
+ *		at most BLOCK_SIZE bytes of input each, every one with its
+ *		own code.  A block starts with its type.  The end block is
+ *		just its type.  A raw block has the number of bytes in four
+ *		bytes, most significant first, followed by the bytes.  A
+ *		Huffman block has the number of bytes, then the lengths of
+ *		the codes of all 256 bytes in four bits each, the high four
+ *		bits of a byte first, then the number of bytes of codes,
+ *		then the codes as written by pack.c.  An interleaved block
+ *		is the same, except that the codes are split among
+ *		BLOCK_STREAMS streams, the first ones each coding an equal
+ *		share of the bytes and the last one the rest, and that the
+ *		sizes of all but the last stream come before the number of
+ *		bytes of codes, so that a decoder can read all the streams
+ *		at once.  Codes are limited to MAX_BLOCK_CODE bits.  An ANS
+ *		block has the number of bytes, then the number of bytes
+ *		after it, which are the frequencies and the coded bytes as
+ *		written by ans.c.  A block whose codes would not save space
+ *		is stored raw.
+ *
+ *		encodeBlock stores one block for N bytes of input in OUT,
+ *		which needs room for BLOCK_BOUND(N) bytes, and returns the
+ *		size of the block, and encodeInterleaved and encodeANSBlock
+ *		do the same with an interleaved block and an ANS block.
+ *		readBlock reads one block from a file into a buffer of
+ *		BLOCK_BOUND(BLOCK_SIZE) bytes and returns its size, or -1
+ *		if the file ends or the block is too large.  decodeBlock
+ *		decodes a block read in this way into OUT and returns the
+ *		number of bytes decoded, or -1 if the block is corrupted.
+ *
+ *		compressStream writes a whole stream, of blocks of the
+ *		given type unless they are raw, and returns false if
+ *		reading or writing fails.  decompressStream expects the
+ *		first two bytes to have been read already, and returns
+ *		false if the stream is corrupted.  Both take the
+ *		number of threads to use, up to MAX_THREADS.  Since every
+ *		block is coded on its own and its header gives its size,
+ *		the blocks of a stream can be found without decoding them,
+ *		and so are coded and decoded in parallel and then written
+ *		in order.
+ */
+
+# ifndef BLOCK_H
+# define BLOCK_H
+
+# include <stdio.h>
+# include <stdbool.h>
+
+# define STREAM_MAGIC 035	/* second byte of a stream, after 037 */
+
+# define BLOCK_SIZE (128 * 1024)
+# define BLOCK_BOUND(n) ((n) + 16)
+# define MAX_BLOCK_CODE 15
+# define MAX_THREADS 64
+
+# define BLOCK_END 0
+# define BLOCK_RAW 1
+# define BLOCK_HUFFMAN 2
+# define BLOCK_INTERLEAVED 3
+# define BLOCK_ANS 4
+
+# define BLOCK_STREAMS 4
+
+long encodeBlock(unsigned char *in, long n, unsigned char *out);
+
+long encodeInterleaved(unsigned char *in, long n, unsigned char *out);
+
+long encodeANSBlock(unsigned char *in, long n, unsigned char *out);
+
+long readBlock(FILE *fp, unsigned char *block);
+
+long decodeBlock(unsigned char *block, long size, unsigned char *out);
+
+bool compressStream(FILE *in, FILE *out, int threads, int type);
+
+bool decompressStream(FILE *in, FILE *out, int threads);
+
+# endif /* BLOCK_H */
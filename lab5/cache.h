@@ -0,0 +1,18 @@
+/*
+ * File:	cache.h
+ *
+ * Copyright:	2023, Vladimir Ceban
+ *
+ * Description:	This file defines the size of a cache line on the machines
+ *		we care about.  The priority queues align their arrays and
+ *		their locks to it, either by hand or with aligned_alloc,
+ *		since neither malloc nor an allocator promises more than
+ *		16 byte alignment.
+ */
+
+# ifndef CACHE_H
+# define CACHE_H
+
+# define CACHE_LINE 64
+
+# endif /* CACHE_H */
@@ -0,0 +1,223 @@
+/*
+ * File: codes.c
+ *
+ * Copyright:	2023, Vladimir Ceban
+ *
+ * Description: This file contains functions defined in codes.h. The lengths
+ * are found in place with the method of Moffat and Katajainen: the used
+ * symbols are sorted by count, and since the trees made by joining the two
+ * smallest trees come out in order of count, they can be taken from a second
+ * queue instead of a priority queue, all within one array of counts that ends
+ * up holding the lengths, with no nodes to allocate. Lengths with a limit come
+ * from the package-merge algorithm of Larmore and Hirschberg, which finds the
+ * best code whose lengths are all within it.
+ *
+ */
+
+#include "codes.h"
+#include "typedpq.h"
+#include <assert.h>
+#include <stdlib.h>
+
+// Defines a used symbol and its count, for sorting
+typedef struct leaf {
+  long count;
+  int symbol;
+} LEAF;
+
+// Sorts leaves by count, then by symbol, with a heapsort whose comparison is
+// inlined
+#define LEAF_LESS(x, y)                                                        \
+  ((x).count < (y).count || ((x).count == (y).count && (x).symbol < (y).symbol))
+PQ_DEFINE(leafpq, LEAF, LEAF_LESS)
+
+// Gives every symbol length zero and stores the used ones in leaves, with the
+// first unused ones if fewer than two are used, sorted by count. Returns the
+// number of leaves. Big O complexity: O(n log n), where n is the number of
+// symbols
+static int sortLeaves(long counts[], int n, int lengths[], LEAF leaves[]) {
+  int i, m = 0;
+  for (i = 0; i < n; i++) {
+    lengths[i] = 0;
+    if (counts[i] > 0) {
+      leaves[m].count = counts[i];
+      leaves[m++].symbol = i;
+    }
+  }
+  for (i = 0; m < 2; i++) {
+    if (counts[i] == 0) {
+      leaves[m].count = 0;
+      leaves[m++].symbol = i;
+    }
+  }
+  leafpq_sort(leaves, m);
+  return m;
+}
+
+// Finds the code length of each symbol. Returns false if a code would be
+// longer than limit. Big O complexity: O(n log n) for sorting, then O(n),
+// where n is the number of symbols
+bool huffmanLengths(long counts[], int n, int lengths[], int limit) {
+  assert(counts != NULL && lengths != NULL && n >= 2);
+
+  LEAF *leaves = malloc(sizeof(LEAF) * n);
+  long *a = malloc(sizeof(long) * n);
+  assert(leaves != NULL && a != NULL);
+  int m = sortLeaves(counts, n, lengths, leaves);
+  int i, root, leaf, next;
+  assert(m >= 2);
+  for (i = 0; i < m; i++) {
+    a[i] = leaves[i].count;
+  }
+
+  // join trees from left to right. Tree next goes in a[next], where a leaf
+  // no longer needed used to be, and the count of each tree once joined is
+  // replaced by the index of its parent. The trees from root to next are
+  // still to be joined, and are in order of count like the leaves
+  a[0] += a[1];
+  root = 0;
+  leaf = 2;
+  for (next = 1; next < m - 1; next++) {
+    if (leaf >= m || a[root] < a[leaf]) {
+      a[next] = a[root];
+      a[root++] = next;
+    } else {
+      a[next] = a[leaf++];
+    }
+    if (leaf >= m || (root < next && a[root] < a[leaf])) {
+      a[next] += a[root];
+      a[root++] = next;
+    } else {
+      a[next] += a[leaf++];
+    }
+  }
+
+  // the depth of each tree is one more than that of its parent, and the last
+  // tree is the root
+  a[m - 2] = 0;
+  for (next = m - 3; next >= 0; next--) {
+    a[next] = a[a[next]] + 1;
+  }
+
+  // every level has twice as many nodes as the trees on the level above it,
+  // and those that are not trees are leaves, given out from the right so that
+  // the most common symbols get the shortest codes
+  int avail = 1, used = 0, depth = 0;
+  root = m - 2;
+  next = m - 1;
+  while (avail > 0) {
+    while (root >= 0 && a[root] == depth) {
+      used++;
+      root--;
+    }
+    while (avail > used) {
+      a[next--] = depth;
+      avail--;
+    }
+    avail = 2 * used;
+    depth++;
+    used = 0;
+  }
+
+  bool fits = true;
+  for (i = 0; i < m; i++) {
+    lengths[leaves[i].symbol] = a[i];
+    fits = fits && a[i] <= limit;
+  }
+
+  free(leaves);
+  free(a);
+  return fits;
+}
+
+// Gives out canonical codes for the given lengths, longest codes first.
+// Big O complexity: O(nL), where n is the number of symbols and L is the
+// longest length
+void canonicalCodes(int lengths[], int n, unsigned long codes[]) {
+  assert(lengths != NULL && codes != NULL);
+
+  int i, c, maxlev = 0;
+  for (c = 0; c < n; c++) {
+    maxlev = lengths[c] > maxlev ? lengths[c] : maxlev;
+  }
+
+  unsigned long word = 0;
+  for (i = maxlev; i > 0; i--) {
+    for (c = 0; c < n; c++) {
+      if (lengths[c] == i) {
+        codes[c] = word++;
+      }
+    }
+    word >>= 1;
+  }
+}
+
+// Finds the code length of each symbol so that no code is longer than limit
+// and the coded size is the smallest possible. Big O complexity: O(nL), where
+// n is the number of symbols and L is the limit
+void limitedLengths(long counts[], int n, int lengths[], int limit) {
+  assert(counts != NULL && lengths != NULL && n >= 2 && limit >= 1);
+
+  LEAF *leaves = malloc(sizeof(LEAF) * n);
+  assert(leaves != NULL);
+  int i, j, m = sortLeaves(counts, n, lengths, leaves);
+
+  // no code is ever longer than m - 1, and m codes need at least log2 m bits
+  limit = limit < m - 1 ? limit : m - 1;
+  assert(limit >= 30 || m <= 1L << limit);
+
+  // list j holds the leaves merged with the packages of two items each made
+  // from list j - 1, in order of weight. Only whether each item is a leaf is
+  // kept, in row j of isLeaf
+  long *prev = malloc(sizeof(long) * 2 * m);
+  long *next = malloc(sizeof(long) * 2 * m);
+  bool *isLeaf = malloc(sizeof(bool) * limit * 2 * m);
+  assert(prev != NULL && next != NULL && isLeaf != NULL);
+
+  int size = m;
+  for (i = 0; i < m; i++) {
+    prev[i] = leaves[i].count;
+    isLeaf[i] = true;
+  }
+  for (j = 1; j < limit; j++) {
+    bool *row = isLeaf + j * 2 * m;
+    int a = 0, b = 0, packages = size / 2;
+    size = 0;
+    while (a < m || b < packages) {
+      long package = b < packages ? prev[2 * b] + prev[2 * b + 1] : 0;
+      if (b == packages || (a < m && leaves[a].count <= package)) {
+        next[size] = leaves[a++].count;
+        row[size++] = true;
+      } else {
+        next[size] = package;
+        row[size++] = false;
+        b++;
+      }
+    }
+    long *swap = prev;
+    prev = next;
+    next = swap;
+  }
+
+  // the first 2m - 2 items of the last list make the code. Each leaf among
+  // them adds one to the length of its symbol, and each package takes two
+  // items from the list before. Leaves are in order in every list, so the
+  // leaves taken are always the first ones
+  int take = 2 * m - 2;
+  for (j = limit - 1; j >= 0; j--) {
+    bool *row = isLeaf + j * 2 * m;
+    int used = 0;
+    for (i = 0; i < take; i++) {
+      used += row[i];
+    }
+    for (i = 0; i < used; i++) {
+      lengths[leaves[i].symbol]++;
+    }
+    take = 2 * (take - used);
+  }
+
+  free(leaves);
+  free(prev);
+  free(next);
+  free(isLeaf);
+}
@@ -0,0 +1,31 @@
+/*
+ * File:	codes.h
+ *
+ * Copyright:	2023, Vladimir Ceban
+ *
+ * Description:	This file contains the public function declarations for
+ *		building Huffman codes.  huffmanLengths finds the length of
+ *		the code of each of N symbols from how many times each one
+ *		appears, giving unused symbols length zero, and fails if
+ *		any code would be longer than LIMIT.  At least two symbols
+ *		always get codes, so that the code is complete even when
+ *		only one symbol is used.  limitedLengths instead finds the
+ *		best code with no length over LIMIT, which must leave room
+ *		for all the symbols used.  canonicalCodes then gives out
+ *		the codes themselves as pack.c does: the longest codes
+ *		first, counting up from zero in order of symbol within a
+ *		length.
+ */
+
+# ifndef CODES_H
+# define CODES_H
+
+# include <stdbool.h>
+
+bool huffmanLengths(long counts[], int n, int lengths[], int limit);
+
+void limitedLengths(long counts[], int n, int lengths[], int limit);
+
+void canonicalCodes(int lengths[], int n, unsigned long codes[]);
+
+# endif /* CODES_H */
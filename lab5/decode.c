@@ -0,0 +1,227 @@
+/*
+ * File: decode.c
+ *
+ * Copyright:	2023, Vladimir Ceban
+ *
+ * Description: This file contains functions defined in decode.h. Instead of
+ * walking the Huffman tree one bit at a time, the decoder looks at the next
+ * PRIMARY_BITS bits of input at once. Every code of at most that many bits
+ * fills all entries of the primary table whose index starts with it, so one
+ * lookup gives both the symbol and how many bits to skip. A longer code shares
+ * its first PRIMARY_BITS bits with other long codes only, and that entry points
+ * to a secondary table indexed by the bits that follow, sized for the longest
+ * code under that prefix. Short codes are the common ones, so nearly every
+ * symbol costs one lookup in a table that fits in the L1 cache.
+ *
+ */
+
+#include "decode.h"
+#include "codes.h"
+#include <assert.h>
+#include <stdlib.h>
+
+// Bits looked at by the primary table
+#define PRIMARY_BITS 11
+
+// Defines an entry of a table, either a symbol or a link to a secondary table
+typedef struct entry {
+  int value;            // symbol, or index of the first secondary entry
+  unsigned char length; // bits of the code read at this level
+  unsigned char sub;    // bits indexing the secondary table, 0 for a symbol
+} ENTRY;
+
+// Defines decoder type
+typedef struct decoder {
+  ENTRY primary[1 << PRIMARY_BITS];
+  ENTRY *secondary;
+} DECODER;
+
+// Fills count entries of a table starting at first with a symbol.
+// Big O complexity: O(count)
+static void fill(ENTRY *first, int count, int symbol, int length) {
+  int i;
+  for (i = 0; i < count; i++) {
+    first[i].value = symbol;
+    first[i].length = length;
+    first[i].sub = 0;
+  }
+}
+
+// Creates decoder for the given code lengths, or returns NULL if they do not
+// make a complete prefix code. Big O complexity: O(2^b + s), where b is
+// PRIMARY_BITS and s is the total size of the secondary tables
+DECODER *createDecoder(int lengths[END_SYMBOL + 1]) {
+  assert(lengths != NULL);
+
+  // check that the code is complete: the lengths must satisfy the Kraft
+  // inequality with equality, or some bit strings would decode to nothing
+  long kraft = 0;
+  int c;
+  for (c = 0; c <= END_SYMBOL; c++) {
+    if (lengths[c] < 0 || lengths[c] > MAX_CODE_LENGTH) {
+      return NULL;
+    }
+    if (lengths[c] > 0) {
+      kraft += 1L << (MAX_CODE_LENGTH - lengths[c]);
+    }
+  }
+  if (kraft != 1L << MAX_CODE_LENGTH) {
+    return NULL;
+  }
+
+  // give out the codes exactly as pack does
+  unsigned long codes[END_SYMBOL + 1];
+  canonicalCodes(lengths, END_SYMBOL + 1, codes);
+
+  DECODER *dp = malloc(sizeof(DECODER));
+  assert(dp != NULL);
+
+  // short codes go straight into the primary table, long codes only record
+  // how many bits their prefix's secondary table needs
+  unsigned char subbits[1 << PRIMARY_BITS] = {0};
+  for (c = 0; c <= END_SYMBOL; c++) {
+    int extra = lengths[c] - PRIMARY_BITS;
+    if (lengths[c] == 0) {
+      continue;
+    } else if (extra <= 0) {
+      fill(&dp->primary[codes[c] << -extra], 1 << -extra, c, lengths[c]);
+    } else if (extra > subbits[codes[c] >> extra]) {
+      subbits[codes[c] >> extra] = extra;
+    }
+  }
+
+  // lay out the secondary tables one after another
+  int i, total = 0;
+  for (i = 0; i < 1 << PRIMARY_BITS; i++) {
+    if (subbits[i] > 0) {
+      dp->primary[i].value = total;
+      dp->primary[i].length = PRIMARY_BITS;
+      dp->primary[i].sub = subbits[i];
+      total += 1 << subbits[i];
+    }
+  }
+
+  dp->secondary = malloc(sizeof(ENTRY) * (total > 0 ? total : 1));
+  assert(dp->secondary != NULL);
+
+  // a long code fills the entries of its prefix's table that start with the
+  // rest of its bits
+  for (c = 0; c <= END_SYMBOL; c++) {
+    int extra = lengths[c] - PRIMARY_BITS;
+    if (extra > 0) {
+      ENTRY *link = &dp->primary[codes[c] >> extra];
+      int spare = link->sub - extra;
+      int rest = codes[c] & ((1UL << extra) - 1);
+      fill(&dp->secondary[link->value + (rest << spare)], 1 << spare, c,
+           extra);
+    }
+  }
+
+  return dp;
+}
+
+// Destroys decoder. Big O complexity: O(1)
+void destroyDecoder(DECODER *dp) {
+  assert(dp != NULL);
+  free(dp->secondary);
+  free(dp);
+}
+
+// Returns the table entry for the next code in the input and skips its bits.
+// Needs MAX_CODE_LENGTH bits in the reader. Big O complexity: O(1)
+static inline ENTRY *nextEntry(DECODER *dp, BITREADER *br) {
+  ENTRY *ep = &dp->primary[peekBits(br, PRIMARY_BITS)];
+  if (ep->sub > 0) {
+    skipBits(br, PRIMARY_BITS);
+    ep = &dp->secondary[ep->value + peekBits(br, ep->sub)];
+  }
+  skipBits(br, ep->length);
+  return ep;
+}
+
+// Decodes bytes into out until the end of file symbol. Returns the number of
+// bytes decoded, or -1 if the input runs out first or there would be more than
+// size bytes. Big O complexity: O(n), where n is the number of bytes
+long decodeBytes(DECODER *dp, BITREADER *br, unsigned char *out, long size) {
+  assert(dp != NULL && br != NULL && (out != NULL || size == 0));
+
+  long n = 0;
+  ENTRY *ep;
+
+  // a refill leaves at least 56 bits, enough for two codes of 24 bits
+  for (;;) {
+    refillBits(br);
+
+    ep = nextEntry(dp, br);
+    if (ep->value == END_SYMBOL || n == size) {
+      break;
+    }
+    out[n++] = ep->value;
+
+    ep = nextEntry(dp, br);
+    if (ep->value == END_SYMBOL || n == size) {
+      break;
+    }
+    out[n++] = ep->value;
+  }
+
+  return ep->value == END_SYMBOL && !overrun(br) ? n : -1;
+}
+
+// Decodes exactly n bytes into out, for codes without an end of file symbol.
+// The caller checks the reader for overrun afterwards. Big O complexity: O(n)
+void decodeSymbols(DECODER *dp, BITREADER *br, unsigned char *out, long n) {
+  assert(dp != NULL && br != NULL && (out != NULL || n == 0));
+
+  long i = 0;
+  while (n - i >= 2) {
+    refillBits(br);
+    out[i++] = nextEntry(dp, br)->value;
+    out[i++] = nextEntry(dp, br)->value;
+  }
+
+  if (i < n) {
+    refillBits(br);
+    out[i++] = nextEntry(dp, br)->value;
+  }
+}
+
+// Decodes n bytes split among four streams, the first three with a quarter of
+// the bytes each and the last with the rest. The four readers are advanced in
+// turn, so that the lookups of one do not wait for the shifts of another. The
+// caller checks every reader for overrun afterwards. Big O complexity: O(n)
+void decodeStreams(DECODER *dp, BITREADER br[4], unsigned char *out, long n) {
+  assert(dp != NULL && br != NULL && (out != NULL || n == 0));
+
+  // work on copies, which the compiler can keep in registers as the stores to
+  // out cannot change them
+  BITREADER b0 = br[0], b1 = br[1], b2 = br[2], b3 = br[3];
+  long quarter = n / 4, i = 0;
+  unsigned char *o0 = out, *o1 = o0 + quarter, *o2 = o1 + quarter;
+  unsigned char *o3 = o2 + quarter;
+
+  while (quarter - i >= 2) {
+    refillBits(&b0);
+    refillBits(&b1);
+    refillBits(&b2);
+    refillBits(&b3);
+    o0[i] = nextEntry(dp, &b0)->value;
+    o1[i] = nextEntry(dp, &b1)->value;
+    o2[i] = nextEntry(dp, &b2)->value;
+    o3[i] = nextEntry(dp, &b3)->value;
+    o0[i + 1] = nextEntry(dp, &b0)->value;
+    o1[i + 1] = nextEntry(dp, &b1)->value;
+    o2[i + 1] = nextEntry(dp, &b2)->value;
+    o3[i + 1] = nextEntry(dp, &b3)->value;
+    i += 2;
+  }
+
+  decodeSymbols(dp, &b0, o0 + i, quarter - i);
+  decodeSymbols(dp, &b1, o1 + i, quarter - i);
+  decodeSymbols(dp, &b2, o2 + i, quarter - i);
+  decodeSymbols(dp, &b3, o3 + i, n - 3 * quarter - i);
+  br[0] = b0;
+  br[1] = b1;
+  br[2] = b2;
+  br[3] = b3;
+}
@@ -0,0 +1,40 @@
+/*
+ * File:	decode.h
+ *
+ * Copyright:	2023, Vladimir Ceban
+ *
+ * Description:	This file contains the public function and type
+ *		declarations for a table-driven decoder of the canonical
+ *		Huffman codes written by pack.c.  The decoder is built from
+ *		the length of the code of each of the 256 bytes and the end
+ *		of file symbol, where a length of zero means the symbol has
+ *		no code.  Codes may be up to MAX_CODE_LENGTH bits long.
+ *		decodeBytes stops at the end of file symbol, while
+ *		decodeSymbols decodes a given number of bytes, for codes
+ *		that have no end of file symbol, and decodeStreams does the
+ *		same for bytes whose codes were split among four streams,
+ *		the first three holding a quarter of them each and the last
+ *		the rest, reading all four at once.
+ */
+
+# ifndef DECODE_H
+# define DECODE_H
+
+# include "bitio.h"
+
+# define END_SYMBOL 256
+# define MAX_CODE_LENGTH 24
+
+typedef struct decoder DECODER;
+
+DECODER *createDecoder(int lengths[END_SYMBOL + 1]);
+
+void destroyDecoder(DECODER *dp);
+
+long decodeBytes(DECODER *dp, BITREADER *br, unsigned char *out, long size);
+
+void decodeSymbols(DECODER *dp, BITREADER *br, unsigned char *out, long n);
+
+void decodeStreams(DECODER *dp, BITREADER br[4], unsigned char *out, long n);
+
+# endif /* DECODE_H */
@@ -0,0 +1,152 @@
+/*
+ * File:	dijkstra.c
+ *
+ * Copyright:	2023, Vladimir Ceban
+ *
+ * Description:	Read a directed graph with non-negative edge weights from
+ *		the standard input and write the length of the shortest
+ *		path from the source vertex to every vertex on the standard
+ *		output.  The input is the number of vertices followed by
+ *		one "from to weight" triple per edge, with vertices
+ *		numbered from zero.
+ *
+ *		Dijkstra's algorithm is used with an addressable priority
+ *		queue.  Every vertex is in the queue at most once; when a
+ *		shorter path to a vertex is found, its key is lowered in
+ *		place with decreaseKey instead of adding it a second time.
+ *
+ *		usage: dijkstra [source]
+ */
+
+# include <stdio.h>
+# include <stdlib.h>
+# include <assert.h>
+# include "apqueue.h"
+
+# define INFINITE -1L
+
+typedef struct vertex VERTEX;
+typedef struct edge EDGE;
+
+struct vertex {
+    long dist;			/* INFINITE until reached */
+    HANDLE *hp;			/* non-null while in the queue */
+    EDGE *edges;
+};
+
+struct edge {
+    int to;
+    long weight;
+    EDGE *next;
+};
+
+
+/*
+ * Function:	distcmp
+ *
+ * Description:	Given pointers to two vertices, compare their distances as
+ *		in strcmp.
+ */
+
+static int distcmp(VERTEX *v1, VERTEX *v2)
+{
+    return (v1->dist < v2->dist) ? -1 : (v1->dist > v2->dist);
+}
+
+
+/*
+ * Function:	main
+ *
+ * Description:	Driver function for the dijkstra application.
+ */
+
+int main(int argc, char *argv[])
+{
+    int i, n, from, to, source;
+    long weight, dist;
+    VERTEX *vertices, *vp;
+    EDGE *ep;
+    APQ *apq;
+
+
+    source = argc > 1 ? atoi(argv[1]) : 0;
+
+    if (scanf("%d", &n) != 1 || n <= 0 || source < 0 || source >= n) {
+	fprintf(stderr, "usage: %s [source] < graph\n", argv[0]);
+	exit(EXIT_FAILURE);
+    }
+
+    vertices = malloc(sizeof(VERTEX) * n);
+    assert(vertices != NULL);
+
+    for (i = 0; i < n; i ++) {
+	vertices[i].dist = INFINITE;
+	vertices[i].hp = NULL;
+	vertices[i].edges = NULL;
+    }
+
+
+    /* Read in the edges. */
+
+    while (scanf("%d %d %ld", &from, &to, &weight) == 3) {
+	if (from < 0 || from >= n || to < 0 || to >= n || weight < 0) {
+	    fprintf(stderr, "%s: bad edge %d %d %ld\n", argv[0], from, to,
+		    weight);
+	    exit(EXIT_FAILURE);
+	}
+
+	ep = malloc(sizeof(EDGE));
+	assert(ep != NULL);
+
+	ep->to = to;
+	ep->weight = weight;
+	ep->next = vertices[from].edges;
+	vertices[from].edges = ep;
+    }
+
+
+    /* Settle the closest vertex in the queue until it is empty. */
+
+    apq = createAPQ(distcmp);
+    vertices[source].dist = 0;
+    vertices[source].hp = addAPQEntry(apq, &vertices[source]);
+
+    while (numAPQEntries(apq) > 0) {
+	vp = removeAPQEntry(apq);
+	vp->hp = NULL;
+
+	for (ep = vp->edges; ep != NULL; ep = ep->next) {
+	    dist = vp->dist + ep->weight;
+
+	    if (vertices[ep->to].dist == INFINITE) {
+		vertices[ep->to].dist = dist;
+		vertices[ep->to].hp = addAPQEntry(apq, &vertices[ep->to]);
+
+	    } else if (dist < vertices[ep->to].dist &&
+		    vertices[ep->to].hp != NULL) {
+		vertices[ep->to].dist = dist;
+		decreaseKey(apq, vertices[ep->to].hp);
+	    }
+	}
+    }
+
+    destroyAPQ(apq);
+
+
+    /* Print out the distances. */
+
+    for (i = 0; i < n; i ++) {
+	if (vertices[i].dist == INFINITE)
+	    printf("%d: unreachable\n", i);
+	else
+	    printf("%d: %ld\n", i, vertices[i].dist);
+
+	while ((ep = vertices[i].edges) != NULL) {
+	    vertices[i].edges = ep->next;
+	    free(ep);
+	}
+    }
+
+    free(vertices);
+    exit(EXIT_SUCCESS);
+}
@@ -0,0 +1,147 @@
+/*
+ * File:	histbench.c
+ *
+ * Copyright:	2023, Vladimir Ceban
+ *
+ * Description:	Measure how fast the bytes of a file can be counted.  The
+ *		file is copied over and over into a buffer of the given
+ *		number of megabytes, and the buffer is then counted three
+ *		ways: with fgetc as huffman.c used to, with a loop into a
+ *		single table, and with countBytes from histogram.c.  The
+ *		speed of each is printed in GB/s, and the counts must all
+ *		agree.
+ *
+ *		usage: histbench file [megabytes]
+ */
+
+# define _GNU_SOURCE		/* for fmemopen() */
+# include <time.h>
+# include <stdio.h>
+# include <stdlib.h>
+# include <string.h>
+# include "histogram.h"
+
+
+/*
+ * Function:	nanoseconds
+ *
+ * Description:	Return the current time in nanoseconds.
+ */
+
+static double nanoseconds(void)
+{
+    struct timespec ts;
+
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+
+/*
+ * Function:	countGetc
+ *
+ * Description:	Count the bytes in the buffer by reading them with fgetc
+ *		from a stream over the buffer.
+ */
+
+static void countGetc(unsigned char *buf, long n, long counts[256])
+{
+    int c;
+    FILE *fp;
+
+
+    fp = fmemopen(buf, n, "rb");
+
+    while ((c = fgetc(fp)) != EOF)
+	counts[c] ++;
+
+    fclose(fp);
+}
+
+
+/*
+ * Function:	countSimple
+ *
+ * Description:	Count the bytes in the buffer into a single table.
+ */
+
+static void countSimple(unsigned char *buf, long n, long counts[256])
+{
+    long i;
+
+
+    for (i = 0; i < n; i ++)
+	counts[buf[i]] ++;
+}
+
+
+/*
+ * Function:	main
+ *
+ * Description:	Driver function for the histbench application.
+ */
+
+int main(int argc, char *argv[])
+{
+    int i;
+    long n, size, len, counts[3][256];
+    double start;
+    unsigned char *buf;
+    FILE *fp;
+    char *names[] = {"fgetc", "one table", "countBytes"};
+    void (*counters[])(unsigned char *, long, long [256]) = {
+	countGetc, countSimple, countBytes
+    };
+
+
+    if (argc < 2 || argc > 3 || (argc == 3 && atol(argv[2]) <= 0)) {
+	fprintf(stderr, "usage: %s file [megabytes]\n", argv[0]);
+	exit(EXIT_FAILURE);
+    }
+
+    if ((fp = fopen(argv[1], "rb")) == NULL) {
+	fprintf(stderr, "%s: cannot open %s\n", argv[0], argv[1]);
+	exit(EXIT_FAILURE);
+    }
+
+    size = (argc == 3 ? atol(argv[2]) : 1024) << 20;
+    buf = malloc(size);
+
+    if (buf == NULL) {
+	fprintf(stderr, "%s: cannot allocate %ld bytes\n", argv[0], size);
+	exit(EXIT_FAILURE);
+    }
+
+
+    /* Fill the buffer with copies of the file. */
+
+    if ((len = fread(buf, 1, size, fp)) == 0) {
+	fprintf(stderr, "%s: %s is empty\n", argv[0], argv[1]);
+	exit(EXIT_FAILURE);
+    }
+
+    fclose(fp);
+
+    for (n = len; n < size; n += len)
+	memcpy(buf + n, buf, n + len <= size ? len : size - n);
+
+
+    /* Count it each way. */
+
+    for (i = 0; i < 3; i ++) {
+	memset(counts[i], 0, sizeof(counts[i]));
+	start = nanoseconds();
+	counters[i](buf, size, counts[i]);
+	printf("%-12s %6.2f GB/s\n", names[i], size / (nanoseconds() -
+		    start));
+
+	if (memcmp(counts[i], counts[0], sizeof(counts[0])) != 0) {
+	    fprintf(stderr, "%s: %s counts differ\n", argv[0], names[i]);
+	    exit(EXIT_FAILURE);
+	}
+    }
+
+    free(buf);
+    exit(EXIT_SUCCESS);
+}
@@ -0,0 +1,99 @@
+/*
+ * File: histogram.c
+ *
+ * Copyright:	2023, Vladimir Ceban
+ *
+ * Description: This file contains functions defined in histogram.h. Counting
+ * bytes with one table is slow on text, where the same byte often comes up
+ * again right away: each increment has to wait for the store of the one
+ * before it to the same counter. Here consecutive bytes go to NUM_TABLES
+ * different tables, so repeated bytes hit different counters and the
+ * increments can run in parallel. The tables are added up at the end. Files
+ * are read in large blocks instead of a byte at a time with fgetc.
+ *
+ */
+
+#include "histogram.h"
+#include <assert.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Number of tables the bytes are spread over
+#define NUM_TABLES 4
+
+// Most bytes counted before the tables are added up, so that no 32-bit
+// counter can overflow
+#define MAX_CHUNK (1L << 30)
+
+// Size of each block read from a file
+#define BLOCK_SIZE (1 << 20)
+
+// Counts the bytes of a chunk into the tables, eight bytes per load.
+// Big O complexity: O(n), where n is the number of bytes
+static void countChunk(unsigned char *buf, long n,
+                       uint32_t tables[NUM_TABLES][256]) {
+  long i;
+  uint64_t word;
+
+  for (i = 0; i + 8 <= n; i += 8) {
+    memcpy(&word, buf + i, sizeof(word));
+    tables[0][word & 0xff]++;
+    tables[1][(word >> 8) & 0xff]++;
+    tables[2][(word >> 16) & 0xff]++;
+    tables[3][(word >> 24) & 0xff]++;
+    tables[0][(word >> 32) & 0xff]++;
+    tables[1][(word >> 40) & 0xff]++;
+    tables[2][(word >> 48) & 0xff]++;
+    tables[3][word >> 56]++;
+  }
+
+  // the last few bytes
+  for (; i < n; i++) {
+    tables[0][buf[i]]++;
+  }
+}
+
+// Adds the number of times each byte value appears in buf to counts.
+// Big O complexity: O(n), where n is the number of bytes
+void countBytes(unsigned char *buf, long n, long counts[256]) {
+  assert((buf != NULL || n == 0) && counts != NULL);
+  uint32_t tables[NUM_TABLES][256];
+
+  while (n > 0) {
+    long chunk = n < MAX_CHUNK ? n : MAX_CHUNK;
+    memset(tables, 0, sizeof(tables));
+    countChunk(buf, chunk, tables);
+
+    // add the tables up
+    int c, t;
+    for (c = 0; c < 256; c++) {
+      for (t = 0; t < NUM_TABLES; t++) {
+        counts[c] += tables[t][c];
+      }
+    }
+
+    buf += chunk;
+    n -= chunk;
+  }
+}
+
+// Adds the number of times each byte value appears in the rest of the file to
+// counts, reading it in large blocks. Returns the number of bytes read.
+// Big O complexity: O(n), where n is the number of bytes
+long countFile(FILE *fp, long counts[256]) {
+  assert(fp != NULL && counts != NULL);
+
+  unsigned char *block = malloc(BLOCK_SIZE);
+  assert(block != NULL);
+
+  long total = 0;
+  size_t n;
+  while ((n = fread(block, 1, BLOCK_SIZE, fp)) > 0) {
+    countBytes(block, n, counts);
+    total += n;
+  }
+
+  free(block);
+  return total;
+}
@@ -0,0 +1,22 @@
+/*
+ * File:	histogram.h
+ *
+ * Copyright:	2023, Vladimir Ceban
+ *
+ * Description:	This file contains the public function declarations for
+ *		counting how many times each byte value appears in a
+ *		buffer or a file.  Both functions add to the counts they
+ *		are given instead of starting from zero, so a file can be
+ *		counted in pieces.
+ */
+
+# ifndef HISTOGRAM_H
+# define HISTOGRAM_H
+
+# include <stdio.h>
+
+void countBytes(unsigned char *buf, long n, long counts[256]);
+
+long countFile(FILE *fp, long counts[256]);
+
+# endif /* HISTOGRAM_H */
@@ -7,28 +7,53 @@
  * it in a different, smaller file with user-specified name using huffman's
  * algorythm.
  *
+ * usage: huffman [-l limit] input-file output-file
+ *        huffman -s [-4 | -a] [-j threads] [input-file [output-file]]
+ *
+ * With -s, the input is compressed in one pass into the stream format of
+ * block.c, so it can come from a pipe and be of any size. A missing file name
+ * or "-" means the standard input or output. With -j, which implies -s, its
+ * blocks are compressed by the given number of threads. With -4, which also
+ * implies -s, the codes of each block are split among four streams, which
+ * unhuffman decodes at once for speed. With -a, which implies -s too, the
+ * blocks are coded with tANS instead of Huffman codes, which spends less than
+ * a bit on the most common bytes.
+ *
+ * With -l, no code is longer than the given number of bits, so that files
+ * which would otherwise need longer codes than pack.c allows can still be
+ * compressed, and short codes can be decoded in a single table lookup.
+ *
  * See comments for the functions below for mode detailed desctiption for each
  * of them.
  *
  */
 
 #include "assert.h"
+#include "block.h"
+#include "codes.h"
 #include "ctype.h"
+#include "histogram.h"
 #include "pack.h"
-#include "pqueue.h"
 #include "stdio.h"
 #include "stdlib.h"
 #include "string.h"
+#include "unistd.h"
 
 // Defines the max size of the array
 #define SIZE 257
 
+// Defines the range of limits on the length of a code, enough for all
+// characters and no more than pack.c allows
+#define MIN_LIMIT 9
+#define MAX_LIMIT 24
+
 // Defines type for node struct
 typedef struct node NODE;
 
 // Defines the functions to be used later
 static NODE *makeNode(int, NODE *, NODE *);
-static int compare(NODE *, NODE *);
+static int compare(const void *, const void *);
+static NODE *smallest(NODE **, int *, int, NODE **, int *, int);
 static int depth(NODE *);
 
 // Creates a new node and sets parents for left and right nodes.
@@ -47,11 +72,23 @@ static NODE *makeNode(int count, NODE *left, NODE *right) {
   return newNode;
 }
 
-// Compares left and right nodes, returns a negative number if left is larger,
-// a positive number if right is larger, or 0 if they're equal.
+// Compares the nodes pointed to by left and right, returns a negative number if
+// right is larger, a positive number if left is larger, or 0 if they're equal.
 // Big O complexity: O(1),
-static int compare(NODE *left, NODE *right) {
-  return left->count - right->count;
+static int compare(const void *left, const void *right) {
+  NODE *x = *(NODE **)left, *y = *(NODE **)right;
+  return (x->count > y->count) - (x->count < y->count);
+}
+
+// Removes and returns the smaller of the next leaf and the next joined tree,
+// taking the leaf if they're equal. Big O complexity: O(1)
+static NODE *smallest(NODE **leaves, int *leaf, int numLeaves, NODE **trees,
+                      int *tree, int numTrees) {
+  if (*tree == numTrees ||
+      (*leaf < numLeaves && leaves[*leaf]->count <= trees[*tree]->count)) {
+    return leaves[(*leaf)++];
+  }
+  return trees[(*tree)++];
 }
 
 // Calculates and retruns the height of the tree.
@@ -65,10 +102,86 @@ static int depth(NODE *node) {
   return d;
 }
 
+// Opens the named file, or returns std if there is no name or it is "-".
+// Big O complexity: O(1)
+static FILE *openFile(char *name, char *mode, FILE *std) {
+  if (name == NULL || strcmp(name, "-") == 0) {
+    return std;
+  }
+  FILE *fp = fopen(name, mode);
+  if (fp == NULL) {
+    perror(name);
+    exit(EXIT_FAILURE);
+  }
+  return fp;
+}
+
+// Prints how to use the program and exits. Big O complexity: O(1)
+static void usage(char *name) {
+  fprintf(stderr, "usage: %s [-l limit] input-file output-file\n", name);
+  fprintf(stderr, "       %s -s [-4 | -a] [-j threads] ", name);
+  fprintf(stderr, "[input-file [output-file]]\n");
+  exit(EXIT_FAILURE);
+}
+
 // Receives the name of input file and the name of desired output file.
 // Compresses the input file and retruns it as output file. Big O complexity:
 // O(n), where n is the number of unique characters in the input file.
 int main(int argc, char *argv[]) {
+  char *name = argv[0];
+  int opt, stream = 0, type = BLOCK_HUFFMAN, threads = 1, limit = 0;
+  while ((opt = getopt(argc, argv, "s4aj:l:")) != -1) {
+    if (opt == 's') {
+      stream = 1;
+    } else if (opt == '4') {
+      stream = 1;
+      type = BLOCK_INTERLEAVED;
+    } else if (opt == 'a') {
+      stream = 1;
+      type = BLOCK_ANS;
+    } else if (opt == 'j') {
+      stream = 1;
+      threads = atoi(optarg);
+      if (threads < 1 || threads > MAX_THREADS) {
+        fprintf(stderr, "%s: threads must be 1 to %d\n", name, MAX_THREADS);
+        exit(EXIT_FAILURE);
+      }
+    } else if (opt == 'l') {
+      limit = atoi(optarg);
+      if (limit < MIN_LIMIT || limit > MAX_LIMIT) {
+        fprintf(stderr, "%s: limit must be %d to %d\n", name, MIN_LIMIT,
+                MAX_LIMIT);
+        exit(EXIT_FAILURE);
+      }
+    } else {
+      usage(name);
+    }
+  }
+  argc -= optind;
+  argv += optind - 1; // keep the names at argv[1] and argv[2]
+
+  // compress in one pass from file or pipe to file or pipe
+  if (stream) {
+    if (argc > 2 || limit > 0) {
+      usage(name);
+    }
+    FILE *in = openFile(argc > 0 ? argv[1] : NULL, "rb", stdin);
+    FILE *out = openFile(argc > 1 ? argv[2] : NULL, "wb", stdout);
+    if (!compressStream(in, out, threads, type)) {
+      perror(ferror(in) ? (argc > 0 ? argv[1] : "stdin")
+                        : (argc > 1 ? argv[2] : "stdout"));
+      exit(EXIT_FAILURE);
+    }
+    if (fclose(out) != 0) {
+      perror(argc > 1 ? argv[2] : "stdout");
+      exit(EXIT_FAILURE);
+    }
+    return 0;
+  }
+
+  if (argc != 2) {
+    usage(name);
+  }
 
   // Open input file for read, and check if it was successfull.
   FILE *inputFile = fopen(argv[1], "r");
@@ -79,45 +192,68 @@ int main(int argc, char *argv[]) {
   assert(outputFile != NULL);
 
   // contains the number of appearances for each character
-  int counts[SIZE] = {0}; // set them all to 0 for now
+  long counts[SIZE] = {0}; // set them all to 0 for now
   // contains all nodes that are present in the file
   NODE *nodes[SIZE] = {NULL}; // set them all to NULL for now
   int i;
-  // priority queue that will help us create the tree
-  PQ *q = createQueue(compare);
 
-  // count the number of appearances for each character in input file
-  while ((i = fgetc(inputFile)) != EOF) {
-    counts[i]++;
-  }
+  // count the number of appearances for each character in input file, reading
+  // it in large blocks
+  countFile(inputFile, counts);
 
   // create a node for each character that appeared in the input file
-  // add these node into the priority queue
+  // and an extra node of EOF char, and sort them by count
+  NODE *leaves[SIZE], *trees[SIZE];
+  int numLeaves = 0, numTrees = 0, leaf = 0, tree = 0;
   for (i = 0; i < SIZE; i++) {
-    if (counts[i] > 0) {
+    if (counts[i] > 0 || i == SIZE - 1) {
       nodes[i] = makeNode(counts[i], NULL, NULL);
-      addEntry(q, nodes[i]);
+      leaves[numLeaves++] = nodes[i];
     }
   }
-  // create an extra node of EOF char and add it to the queue
-  nodes[SIZE - 1] = makeNode(counts[SIZE - 1], NULL, NULL);
-  addEntry(q, nodes[SIZE - 1]);
-
-  // create the tree out of the nodes by removing two of them and inserting the
-  // sum of their counts back as their parent untill there's only one left.
-  // this final node will be the root of the tree
-  while (numEntries(q) >= 2) {
-    NODE *right = removeEntry(q);
-    NODE *left = removeEntry(q);
-    NODE *parent = makeNode(right->count + left->count, left, right);
-    addEntry(q, parent);
+  qsort(leaves, numLeaves, sizeof(NODE *), compare);
+
+  // create the tree out of the nodes by removing the two smallest and
+  // inserting the sum of their counts back as their parent untill there's only
+  // one left. the parents come out in order of count too, so the smallest are
+  // always at the front of the leaves or of the parents, and no priority queue
+  // is needed. this final node will be the root of the tree
+  while (numLeaves - leaf + numTrees - tree >= 2) {
+    NODE *right = smallest(leaves, &leaf, numLeaves, trees, &tree, numTrees);
+    NODE *left = smallest(leaves, &leaf, numLeaves, trees, &tree, numTrees);
+    trees[numTrees++] = makeNode(right->count + left->count, left, right);
+  }
+
+  // find the length of each code from the tree, or from the counts if it is
+  // limited, with the EOF char appearing once
+  int lengths[SIZE] = {0};
+  if (limit > 0) {
+    counts[SIZE - 1] = 1;
+    limitedLengths(counts, SIZE, lengths, limit);
+
+    // pack.c needs the EOF char to have one of the longest codes, so swap its
+    // length with that of the char with the longest code, which appears at
+    // least as often and so is coded no better than before
+    int longest = SIZE - 1;
+    for (i = 0; i < SIZE; i++) {
+      longest = lengths[i] > lengths[longest] ? i : longest;
+    }
+    int length = lengths[longest];
+    lengths[longest] = lengths[SIZE - 1];
+    lengths[SIZE - 1] = length;
+  } else {
+    for (i = 0; i < SIZE; i++) {
+      if (nodes[i] != NULL) {
+        lengths[i] = depth(nodes[i]);
+      }
+    }
   }
 
   // prints out the number of appearances and saved size for each character
   for (i = 0; i < SIZE; i++) {
     NODE *node = nodes[i];
     if (node != NULL) {
-      int height = depth(node);
+      int height = lengths[i];
       // if not printable, print the code of the char
       if (!isprint(i)) {
         printf("%03o: %d x %d bits = %d bits\n", i, node->count, height,
@@ -130,8 +266,17 @@ int main(int argc, char *argv[]) {
     }
   }
 
-  // call the archivation funtion
-  pack(argv[1], argv[2], nodes);
+  // call the archivation funtion, with the tree unless the lengths are limited
+  if (limit > 0) {
+    long sum = 0;
+    for (i = 0; i < SIZE - 1; i++) {
+      sum += counts[i] * lengths[i];
+    }
+    printf("total bits required = %ld\n", sum);
+    packLengths(argv[1], argv[2], lengths);
+  } else {
+    pack(argv[1], argv[2], nodes);
+  }
 
   // close the files
   fclose(inputFile);
@@ -0,0 +1,270 @@
+/*
+ * File:	mqbench.c
+ *
+ * Copyright:	2023, Vladimir Ceban
+ *
+ * Description:	Measure the MultiQueue in mqueue.c.  First, for 1 to 8
+ *		threads, every thread runs the hold model (remove an
+ *		entry, then add it back with a larger key) on a prefilled
+ *		queue, and the number of operations per second is printed
+ *		for the MultiQueue with c * P heaps and for a single heap
+ *		from pqueue.c behind one lock.  Second, the rank error is
+ *		measured: a MultiQueue is filled with the keys 1 to N and
+ *		then emptied, and for each removed key we count how many
+ *		smaller keys were still in the queue.
+ *
+ *		usage: mqbench [-c heaps per thread] [-n operations]
+ */
+
+# include <time.h>
+# include <stdio.h>
+# include <stdint.h>
+# include <stdlib.h>
+# include <assert.h>
+# include <unistd.h>		/* for getopt() */
+# include <pthread.h>
+# include "pqueue.h"
+# include "mqueue.h"
+
+# define MAX_THREADS 8
+# define PREFILL 1000000
+# define RANK_KEYS 100000
+
+/* Keys are stored directly in the entry pointers, starting at one since
+   the queues do not allow null pointers. */
+
+# define ENTRY(k)	((void *) (intptr_t) (k))
+# define KEY(p)		((intptr_t) (p))
+
+typedef struct bench BENCH;
+
+struct bench {
+    MQ *mq;			/* either the MultiQueue */
+    PQ *pq;			/* or the locked heap */
+    pthread_mutex_t *lock;
+    long ops;
+    unsigned seed;
+};
+
+
+/*
+ * Function:	keycmp
+ *
+ * Description:	Compare two keys as in strcmp.
+ */
+
+static int keycmp(void *p1, void *p2)
+{
+    return (KEY(p1) < KEY(p2)) ? -1 : (KEY(p1) > KEY(p2));
+}
+
+
+/*
+ * Function:	hold
+ *
+ * Description:	Thread body for the throughput test.  Each iteration
+ *		removes the smallest entry and adds it back with a key
+ *		that is larger by a random amount.
+ */
+
+static void *hold(void *arg)
+{
+    BENCH *bp = arg;
+    void *entry;
+    long i;
+
+
+    for (i = 0; i < bp->ops; i ++) {
+	if (bp->mq != NULL) {
+	    entry = removeMultiEntry(bp->mq);
+	    addMultiEntry(bp->mq, ENTRY(KEY(entry) + rand_r(&bp->seed) % 1000 + 1));
+
+	} else {
+	    pthread_mutex_lock(bp->lock);
+	    entry = removeEntry(bp->pq);
+	    addEntry(bp->pq, ENTRY(KEY(entry) + rand_r(&bp->seed) % 1000 + 1));
+	    pthread_mutex_unlock(bp->lock);
+	}
+    }
+
+    return NULL;
+}
+
+
+/*
+ * Function:	throughput
+ *
+ * Description:	Run the hold model with the given number of threads on
+ *		either a MultiQueue or the locked heap and return the
+ *		number of operations per second, counting a remove and an
+ *		add as two operations.
+ */
+
+static double throughput(int nthreads, int factor, long ops)
+{
+    int i;
+    double secs;
+    struct timespec t0, t1;
+    pthread_t threads[MAX_THREADS];
+    BENCH bench[MAX_THREADS];
+    pthread_mutex_t lock;
+    MQ *mq;
+    PQ *pq;
+
+
+    mq = NULL;
+    pq = NULL;
+
+    if (factor > 0)
+	mq = createMultiQueue(keycmp, factor * nthreads);
+    else
+	pq = createQueue(keycmp);
+
+    srand(1);
+
+    for (i = 0; i < PREFILL; i ++)
+	if (mq != NULL)
+	    addMultiEntry(mq, ENTRY(rand() % PREFILL + 1));
+	else
+	    addEntry(pq, ENTRY(rand() % PREFILL + 1));
+
+    pthread_mutex_init(&lock, NULL);
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+
+    for (i = 0; i < nthreads; i ++) {
+	bench[i].mq = mq;
+	bench[i].pq = pq;
+	bench[i].lock = &lock;
+	bench[i].ops = ops / nthreads;
+	bench[i].seed = i + 1;
+	pthread_create(&threads[i], NULL, hold, &bench[i]);
+    }
+
+    for (i = 0; i < nthreads; i ++)
+	pthread_join(threads[i], NULL);
+
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    pthread_mutex_destroy(&lock);
+
+    if (mq != NULL) {
+	assert(numMultiEntries(mq) == PREFILL);
+	destroyMultiQueue(mq);
+    } else
+	destroyQueue(pq);
+
+    secs = (t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) / 1e9;
+    return 2.0 * (ops / nthreads) * nthreads / secs;
+}
+
+
+/*
+ * Function:	rankError
+ *
+ * Description:	Fill a MultiQueue of NQUEUES heaps with the keys 1 to N in
+ *		random order and empty it again.  A Fenwick tree over the
+ *		keys still in the queue gives the rank of each removed key
+ *		in O(log N).  The mean and maximum rank error are stored.
+ */
+
+static void rankError(int nqueues, double *mean, int *max)
+{
+    int i, j, k, t, rank, *keys, *tree;
+    long total;
+    MQ *mq;
+
+
+    keys = malloc(sizeof(int) * RANK_KEYS);
+    tree = calloc(RANK_KEYS + 1, sizeof(int));
+    assert(keys != NULL && tree != NULL);
+
+    for (i = 0; i < RANK_KEYS; i ++)
+	keys[i] = i + 1;
+
+    for (i = RANK_KEYS - 1; i > 0; i --) {
+	j = rand() % (i + 1);
+	t = keys[i];
+	keys[i] = keys[j];
+	keys[j] = t;
+    }
+
+    mq = createMultiQueue(keycmp, nqueues);
+
+    for (i = 0; i < RANK_KEYS; i ++) {
+	addMultiEntry(mq, ENTRY(keys[i]));
+
+	for (k = keys[i]; k <= RANK_KEYS; k += k & -k)
+	    tree[k] ++;
+    }
+
+    total = 0;
+    *max = 0;
+
+    for (i = 0; i < RANK_KEYS; i ++) {
+	k = KEY(removeMultiEntry(mq));
+
+	/* count keys still present that are smaller than k */
+
+	rank = 0;
+
+	for (j = k - 1; j > 0; j -= j & -j)
+	    rank += tree[j];
+
+	for (j = k; j <= RANK_KEYS; j += j & -j)
+	    tree[j] --;
+
+	total += rank;
+
+	if (rank > *max)
+	    *max = rank;
+    }
+
+    *mean = (double) total / RANK_KEYS;
+    destroyMultiQueue(mq);
+    free(keys);
+    free(tree);
+}
+
+
+/*
+ * Function:	main
+ *
+ * Description:	Driver function for the mqbench application.
+ */
+
+int main(int argc, char *argv[])
+{
+    int n, opt, max, factor;
+    long ops;
+    double mean;
+
+
+    factor = 2;
+    ops = 4000000;
+
+    while ((opt = getopt(argc, argv, "c:n:")) != -1) {
+	if (opt == 'c' && atoi(optarg) > 0)
+	    factor = atoi(optarg);
+	else if (opt == 'n' && atol(optarg) > 0)
+	    ops = atol(optarg);
+	else {
+	    fprintf(stderr, "usage: %s [-c heaps per thread] [-n operations]\n",
+		    argv[0]);
+	    exit(EXIT_FAILURE);
+	}
+    }
+
+    printf("%-8s %14s %14s\n", "threads", "multiqueue", "locked heap");
+
+    for (n = 1; n <= MAX_THREADS; n *= 2)
+	printf("%-8d %14.0f %14.0f\n", n, throughput(n, factor, ops),
+		throughput(n, 0, ops));
+
+    printf("\n%-8s %14s %14s\n", "heaps", "mean rank err", "max rank err");
+
+    for (n = 2; n <= 64; n *= 2) {
+	rankError(n, &mean, &max);
+	printf("%-8d %14.2f %14d\n", n, mean, max);
+    }
+
+    exit(EXIT_SUCCESS);
+}
@@ -0,0 +1,189 @@
+/*
+ * File: mqueue.c
+ *
+ * Copyright:	2023, Vladimir Ceban
+ *
+ * Description: This file contains functions defined in mqueue.h. The queue is
+ * made of several heaps from pqueue.c, each behind its own lock. With P
+ * threads, about c * P heaps (c = 2 to 4) keep threads from running into each
+ * other's locks most of the time.
+ *
+ * An entry is added to a random heap. To remove, a thread picks two random
+ * heaps and removes from the one whose smallest entry is smaller. Only
+ * try-locks are used: a thread that finds a heap locked just picks again
+ * instead of waiting. Taking the better of two random choices keeps removed
+ * entries close to the true minimum, on average within O(number of heaps)
+ * ranks of it. Both heaps are locked while their smallest entries are
+ * compared, since an entry seen without the lock may already have been
+ * removed and freed by another thread.
+ *
+ */
+
+#include "mqueue.h"
+#include "cache.h"
+#include "pqueue.h"
+#include <assert.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+// Defines one heap and its lock, on its own cache line so that threads
+// working on neighboring heaps do not slow each other down
+typedef struct heap {
+  _Alignas(CACHE_LINE) pthread_mutex_t lock;
+  PQ *pq;
+} HEAP;
+
+// Defines MultiQueue type
+typedef struct multiqueue {
+  int nqueues;
+  HEAP *heaps;
+  atomic_int count;
+  int (*compare)(void *, void *);
+} MQ;
+
+// Returns a random number from a generator private to the calling thread.
+// Big O complexity: O(1)
+static unsigned nextRandom(void) {
+  static _Thread_local uint64_t state = 0;
+
+  // seed each thread differently from the address of its own state
+  if (state == 0) {
+    state = (uintptr_t)&state | 1;
+  }
+
+  // xorshift64*
+  state ^= state >> 12;
+  state ^= state << 25;
+  state ^= state >> 27;
+  return (state * 2685821657736338717ULL) >> 32;
+}
+
+// Removes the smallest entry of a locked heap. Big O complexity: O(log n)
+static void *removeLocked(MQ *mq, HEAP *hp) {
+  atomic_fetch_sub(&mq->count, 1);
+  return removeEntry(hp->pq);
+}
+
+// Creates MultiQueue made of nqueues heaps and returns pointer to it.
+// Big O complexity: O(k), where k is the number of heaps
+MQ *createMultiQueue(int (*compare)(), int nqueues) {
+  assert(compare != NULL && nqueues > 0);
+
+  MQ *mq = malloc(sizeof(MQ));
+  assert(mq != NULL);
+
+  mq->heaps = aligned_alloc(CACHE_LINE, sizeof(HEAP) * nqueues);
+  assert(mq->heaps != NULL);
+
+  mq->nqueues = nqueues;
+  mq->compare = compare;
+  atomic_init(&mq->count, 0);
+
+  int i;
+  for (i = 0; i < nqueues; i++) {
+    pthread_mutex_init(&mq->heaps[i].lock, NULL);
+    mq->heaps[i].pq = createQueue(compare);
+  }
+
+  return mq;
+}
+
+// Destroys MultiQueue and its heaps, entries are not freed.
+// Big O complexity: O(k), where k is the number of heaps
+void destroyMultiQueue(MQ *mq) {
+  assert(mq != NULL);
+
+  int i;
+  for (i = 0; i < mq->nqueues; i++) {
+    pthread_mutex_destroy(&mq->heaps[i].lock);
+    destroyQueue(mq->heaps[i].pq);
+  }
+
+  free(mq->heaps);
+  free(mq);
+}
+
+// Returns number of entries in the queue, only exact when no other thread is
+// adding or removing. Big O complexity: O(1)
+int numMultiEntries(MQ *mq) {
+  assert(mq != NULL);
+  return atomic_load(&mq->count);
+}
+
+// Adds an entry to a random heap that is not locked.
+// Big O complexity: O(log n) expected
+void addMultiEntry(MQ *mq, void *entry) {
+  assert(mq != NULL && entry != NULL);
+  HEAP *hp;
+
+  do {
+    hp = &mq->heaps[nextRandom() % mq->nqueues];
+  } while (pthread_mutex_trylock(&hp->lock) != 0);
+
+  addEntry(hp->pq, entry);
+  atomic_fetch_add(&mq->count, 1);
+
+  pthread_mutex_unlock(&hp->lock);
+}
+
+// Removes the smaller of the smallest entries of two random heaps.
+// Big O complexity: O(log n) expected, O(k log n) when nearly empty
+void *removeMultiEntry(MQ *mq) {
+  assert(mq != NULL);
+  void *entry = NULL;
+  int i, misses = 0;
+
+  // give up on random picks after finding empty heaps k times in a row
+  while (misses < mq->nqueues && atomic_load(&mq->count) > 0) {
+    HEAP *h1 = &mq->heaps[nextRandom() % mq->nqueues];
+    HEAP *h2 = &mq->heaps[nextRandom() % mq->nqueues];
+
+    if (pthread_mutex_trylock(&h1->lock) != 0) {
+      continue;
+    }
+    // if the second heap is busy, the first one alone will do
+    if (h2 == h1 || pthread_mutex_trylock(&h2->lock) != 0) {
+      h2 = NULL;
+    }
+
+    void *m1 = getMinEntry(h1->pq);
+    void *m2 = h2 != NULL ? getMinEntry(h2->pq) : NULL;
+
+    if (m1 != NULL || m2 != NULL) {
+      HEAP *hp = m1 == NULL || (m2 != NULL && mq->compare(m2, m1) < 0) ? h2 : h1;
+      entry = removeLocked(mq, hp);
+    } else {
+      misses++;
+    }
+
+    pthread_mutex_unlock(&h1->lock);
+    if (h2 != NULL) {
+      pthread_mutex_unlock(&h2->lock);
+    }
+
+    if (entry != NULL) {
+      return entry;
+    }
+  }
+
+  // with few entries left random picks mostly find empty heaps, so look at
+  // each heap in turn and take whatever is there
+  for (i = 0; i < mq->nqueues && atomic_load(&mq->count) > 0; i++) {
+    HEAP *hp = &mq->heaps[i];
+    pthread_mutex_lock(&hp->lock);
+
+    if (numEntries(hp->pq) > 0) {
+      entry = removeLocked(mq, hp);
+    }
+
+    pthread_mutex_unlock(&hp->lock);
+
+    if (entry != NULL) {
+      return entry;
+    }
+  }
+
+  return NULL;
+}
@@ -0,0 +1,31 @@
+/*
+ * File:	mqueue.h
+ *
+ * Copyright:	2023, Vladimir Ceban
+ *
+ * Description:	This file contains the public function and type
+ *		declarations for a concurrent relaxed priority queue of
+ *		generic pointer types, known as a MultiQueue.  Any number
+ *		of threads may add and remove entries at the same time.
+ *		In exchange, an entry that is removed is only likely to be
+ *		one of the smallest entries in the queue, not certain to
+ *		be the smallest.  A null return value from removeMultiEntry
+ *		means the queue was empty.
+ */
+
+# ifndef MQUEUE_H
+# define MQUEUE_H
+
+typedef struct multiqueue MQ;
+
+MQ *createMultiQueue(int (*compare)(), int nqueues);
+
+void destroyMultiQueue(MQ *mq);
+
+int numMultiEntries(MQ *mq);
+
+void addMultiEntry(MQ *mq, void *entry);
+
+void *removeMultiEntry(MQ *mq);
+
+# endif /* MQUEUE_H */
@@ -10,31 +10,28 @@
 # include <stdlib.h>
 # include <sys/stat.h>
 # include "pack.h"
+# include "bitio.h"
 
 # define END 256
 # define MAX_LEVELS 24
+# define BUFFER_SIZE 65536
+
+/*
+ * Function:	pack
+ *
+ * Description:	Compress a file using the code given by the Huffman tree
+ *		whose leaves are given, after checking the tree against the
+ *		file.
+ */
 
 void pack(char *infile, char *outfile, struct node *leaves[END + 1])
 {
-    unsigned char byte;
-    int i, c, bitsleft, length[END + 1], levcount[MAX_LEVELS + 1], maxlev, len;
-    unsigned long bits[END + 1], word;
+    int c, length[END + 1];
     struct node *root, *np;
     struct stat buf;
-    FILE *in, *out;
     int sum;
 
 
-    if ((in = fopen(infile, "rb")) == NULL) {
-	perror(infile);
-	exit(errno);
-    }
-
-    if ((out = fopen(outfile, "wb")) == NULL) {
-	perror(outfile);
-	exit(errno);
-    }
-
     if (stat(infile, &buf)) {
 	perror(infile);
 	exit(errno);
@@ -56,34 +53,77 @@ void pack(char *infile, char *outfile, struct node *leaves[END + 1])
     }
 
     sum = 0;
-    maxlev = 0;
-
-    for (i = 0; i <= MAX_LEVELS; i ++)
-	levcount[i] = 0;
 
     for (c = 0; c <= END; c ++) {
-	if (leaves[c] != NULL) {
-	    length[c] = 0;
+	length[c] = 0;
 
+	if (leaves[c] != NULL) {
 	    for (np = leaves[c]; np != root; np = np->parent)
 		length[c] ++;
 
 	    sum += length[c] * leaves[c]->count;
-
-	    if (length[c] > MAX_LEVELS) {
-		fprintf(stderr, "Huffman tree has too many levels\n");
-		exit(EXIT_FAILURE);
-	    } else {
-		levcount[length[c]] ++;
-
-		if (length[c] > maxlev)
-		    maxlev = length[c];
-	    }
-	} else
-	    length[c] = 0;
+	}
     }
 
     printf("total bits required = %d\n", sum);
+    packLengths(infile, outfile, length);
+}
+
+
+/*
+ * Function:	packLengths
+ *
+ * Description:	Compress a file using the canonical code with the given
+ *		length for each byte and the end of file symbol, where a
+ *		length of zero means the byte has no code.
+ */
+
+void packLengths(char *infile, char *outfile, int length[END + 1])
+{
+    unsigned char inbuf[BUFFER_SIZE], outbuf[BUFFER_SIZE];
+    int i, c, n, levcount[MAX_LEVELS + 1], maxlev;
+    unsigned long bits[END + 1], word;
+    BITWRITER bw;
+    struct stat buf;
+    FILE *in, *out;
+
+
+    if ((in = fopen(infile, "rb")) == NULL) {
+	perror(infile);
+	exit(errno);
+    }
+
+    if ((out = fopen(outfile, "wb")) == NULL) {
+	perror(outfile);
+	exit(errno);
+    }
+
+    if (stat(infile, &buf)) {
+	perror(infile);
+	exit(errno);
+    }
+
+    if (buf.st_size == 0) {
+	fprintf(stderr, "Cannot compress empty file.\n");
+	exit(EXIT_FAILURE);
+    }
+
+    maxlev = 0;
+
+    for (i = 0; i <= MAX_LEVELS; i ++)
+	levcount[i] = 0;
+
+    for (c = 0; c <= END; c ++) {
+	if (length[c] > MAX_LEVELS) {
+	    fprintf(stderr, "Huffman tree has too many levels\n");
+	    exit(EXIT_FAILURE);
+	} else if (length[c] > 0) {
+	    levcount[length[c]] ++;
+
+	    if (length[c] > maxlev)
+		maxlev = length[c];
+	}
+    }
 
     word = 0;
 
@@ -115,31 +155,17 @@ void pack(char *infile, char *outfile, struct node *leaves[END + 1])
 	    if (length[c] == i)
 		putc(c, out);
 
-    byte = 0;
-    bitsleft = 8;
+    /* Read the input in blocks and put the code of each byte, then the
+       code of the end of file symbol. */
 
-    do {
-	if ((c = getc(in)) == EOF)
-	    c = END;
+    initWriter(&bw, outbuf, BUFFER_SIZE, out);
 
-	word = bits[c];
-	len = length[c];
+    while ((n = fread(inbuf, 1, BUFFER_SIZE, in)) > 0)
+	for (i = 0; i < n; i ++)
+	    putBits(&bw, bits[inbuf[i]], length[inbuf[i]]);
 
-	while (len >= bitsleft) {
-	    len = len - bitsleft;
-	    byte = (byte << bitsleft) | (word >> len);
-	    putc(byte, out);
-	    bitsleft = 8;
-	}
-
-	byte = (byte << len) | word;
-	bitsleft = bitsleft - len;
-    } while (c != END);
-
-    if (len > 0) {
-	byte = byte << bitsleft;
-	putc(byte, out);
-    }
+    putBits(&bw, bits[END], length[END]);
+    flushBits(&bw);
 
     fclose(in);
     fclose(out);
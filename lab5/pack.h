@@ -14,4 +14,6 @@ struct node {
 
 void pack(char *infile, char *outfile, struct node *leaves[257]);
 
+void packLengths(char *infile, char *outfile, int lengths[257]);
+
 # endif /* PACK_H */
@@ -0,0 +1,477 @@
+/*
+ * File:	pqbench.c
+ *
+ * Copyright:	2023, Vladimir Ceban
+ *
+ * Description:	Measure every priority queue in this directory on the same
+ *		set of workloads.  Each workload is run twice per queue:
+ *		once to measure throughput, and once with every operation
+ *		timed on its own to fill a latency histogram, from which
+ *		the median and 99th percentile are printed.  The workloads
+ *		are:
+ *
+ *		random		add N random keys, then remove them all
+ *		sorted		the same with keys in increasing order
+ *		reverse		the same with keys in decreasing order
+ *		dups		the same with only 16 distinct keys
+ *		hold		fill with N keys, then N times remove the
+ *				smallest and add it back with a larger key
+ *		huffman		fill with N counts, then remove the two
+ *				smallest and add their sum until one is left
+ *
+ *		Every workload removes keys in increasing order, so all
+ *		of them also suit the radix heap.  The MultiQueue is given
+ *		a single heap, since with more it does not remove keys in
+ *		order.
+ *
+ *		usage: pqbench [-n keys]
+ */
+
+# include <time.h>
+# include <stdio.h>
+# include <stdint.h>
+# include <stdbool.h>
+# include <stdlib.h>
+# include <unistd.h>		/* for getopt() */
+# include "pqueue.h"
+# include "apqueue.h"
+# include "mqueue.h"
+# include "rheap.h"
+# include "typedpq.h"
+
+/* Keys are stored directly in the entry pointers, starting at one since
+   the queues do not allow null pointers. */
+
+# define ENTRY(k)	((void *) (uintptr_t) (k))
+# define KEY(p)		((unsigned) (uintptr_t) (p))
+
+/* The histogram has one bucket per nanosecond below 64 ns, and then 32
+   buckets for each power of two, so each bucket is within 3% of its
+   values. */
+
+# define SUB_BITS	5
+# define SUB_BUCKETS	(1 << SUB_BITS)
+# define LINEAR		(2 * SUB_BUCKETS)
+# define NUM_BUCKETS	(LINEAR + 40 * SUB_BUCKETS)
+
+# define LESS(a, b)	((a) < (b))
+
+PQ_DEFINE(intpq, unsigned, LESS)
+
+typedef struct backend BACKEND;
+
+struct backend {
+    char *name;
+    void *(*create)(void);
+    void (*destroy)(void *q);
+    void (*add)(void *q, unsigned key);
+    unsigned (*remove)(void *q);
+};
+
+typedef struct workload WORKLOAD;
+
+struct workload {
+    char *name;
+    long (*run)(BACKEND *bp, void *q, int n);
+};
+
+long histogram[NUM_BUCKETS];
+bool timed;
+
+
+/*
+ * Function:	nanoseconds
+ *
+ * Description:	Return the current time in nanoseconds.
+ */
+
+static long nanoseconds(void)
+{
+    struct timespec ts;
+
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000000L + ts.tv_nsec;
+}
+
+
+/*
+ * Function:	bucket
+ *
+ * Description:	Return the histogram bucket for a time in nanoseconds.
+ */
+
+static int bucket(long ns)
+{
+    int bits;
+
+
+    if (ns < LINEAR)
+	return ns;
+
+    bits = 63 - __builtin_clzl(ns);
+
+    if (bits - SUB_BITS - 1 >= NUM_BUCKETS / SUB_BUCKETS - 2)
+	return NUM_BUCKETS - 1;
+
+    return LINEAR + (bits - SUB_BITS - 1) * SUB_BUCKETS +
+	((ns >> (bits - SUB_BITS)) & (SUB_BUCKETS - 1));
+}
+
+
+/*
+ * Function:	lowest
+ *
+ * Description:	Return the smallest time in nanoseconds in a bucket.
+ */
+
+static long lowest(int b)
+{
+    int bits;
+
+
+    if (b < LINEAR)
+	return b;
+
+    bits = (b - LINEAR) / SUB_BUCKETS + SUB_BITS + 1;
+    return (1L << bits) + ((long) ((b - LINEAR) % SUB_BUCKETS) << (bits -
+		SUB_BITS));
+}
+
+
+/*
+ * Function:	percentile
+ *
+ * Description:	Return the time in nanoseconds below which the given
+ *		fraction of the timed operations fell.
+ */
+
+static long percentile(double fraction)
+{
+    int b;
+    long total, seen;
+
+
+    total = 0;
+
+    for (b = 0; b < NUM_BUCKETS; b ++)
+	total += histogram[b];
+
+    seen = 0;
+
+    for (b = 0; b < NUM_BUCKETS; b ++)
+	if ((seen += histogram[b]) >= total * fraction)
+	    break;
+
+    return lowest(b < NUM_BUCKETS ? b : NUM_BUCKETS - 1);
+}
+
+
+/*
+ * Function:	add
+ *
+ * Description:	Add a key to a queue, timing the operation if needed.
+ */
+
+static void add(BACKEND *bp, void *q, unsigned key)
+{
+    long start;
+
+
+    if (!timed) {
+	bp->add(q, key);
+	return;
+    }
+
+    start = nanoseconds();
+    bp->add(q, key);
+    histogram[bucket(nanoseconds() - start)] ++;
+}
+
+
+/*
+ * Function:	removeMin
+ *
+ * Description:	Remove the smallest key from a queue, timing the operation
+ *		if needed, and exit if it is smaller than the key removed
+ *		before it.
+ */
+
+static unsigned removeMin(BACKEND *bp, void *q, unsigned *last)
+{
+    long start;
+    unsigned key;
+
+
+    if (!timed)
+	key = bp->remove(q);
+    else {
+	start = nanoseconds();
+	key = bp->remove(q);
+	histogram[bucket(nanoseconds() - start)] ++;
+    }
+
+    if (key < *last) {
+	fprintf(stderr, "%s: removed %u after %u\n", bp->name, key, *last);
+	exit(EXIT_FAILURE);
+    }
+
+    *last = key;
+    return key;
+}
+
+
+/*
+ * Function:	addRemove
+ *
+ * Description:	Add the keys made by the function NEXT for I from 0 to N-1
+ *		and then remove them all.  Return the number of operations.
+ */
+
+static long addRemove(BACKEND *bp, void *q, int n, unsigned (*next)(int, int))
+{
+    int i;
+    unsigned last;
+
+
+    for (i = 0; i < n; i ++)
+	add(bp, q, next(i, n));
+
+    last = 0;
+
+    for (i = 0; i < n; i ++)
+	removeMin(bp, q, &last);
+
+    return 2L * n;
+}
+
+
+/*
+ * Functions for the workloads that add N keys and then remove them all,
+ * each with the function that makes the key added I-th.
+ */
+
+static unsigned randomKey(int i, int n) { return rand() % n + 1; }
+static unsigned sortedKey(int i, int n) { return i + 1; }
+static unsigned reverseKey(int i, int n) { return n - i; }
+static unsigned dupKey(int i, int n) { return rand() % 16 + 1; }
+
+static long randomRun(BACKEND *bp, void *q, int n)
+{
+    return addRemove(bp, q, n, randomKey);
+}
+
+static long sortedRun(BACKEND *bp, void *q, int n)
+{
+    return addRemove(bp, q, n, sortedKey);
+}
+
+static long reverseRun(BACKEND *bp, void *q, int n)
+{
+    return addRemove(bp, q, n, reverseKey);
+}
+
+static long dupRun(BACKEND *bp, void *q, int n)
+{
+    return addRemove(bp, q, n, dupKey);
+}
+
+
+/*
+ * Function:	holdRun
+ *
+ * Description:	Run the hold model on a queue of N keys and return the
+ *		number of operations, including filling and emptying the
+ *		queue.  Only the hold operations go into the histogram.
+ */
+
+static long holdRun(BACKEND *bp, void *q, int n)
+{
+    int i;
+    unsigned key, last;
+    bool save;
+
+
+    save = timed;
+    timed = false;
+
+    for (i = 0; i < n; i ++)
+	add(bp, q, rand() % n + 1);
+
+    timed = save;
+    last = 0;
+
+    for (i = 0; i < n; i ++) {
+	key = removeMin(bp, q, &last);
+	add(bp, q, key + rand() % 1000);
+    }
+
+    timed = false;
+
+    for (i = 0; i < n; i ++)
+	removeMin(bp, q, &last);
+
+    timed = save;
+    return 4L * n;
+}
+
+
+/*
+ * Function:	huffmanRun
+ *
+ * Description:	Merge N counts as when building a Huffman tree and return
+ *		the number of operations, including filling the queue.
+ */
+
+static long huffmanRun(BACKEND *bp, void *q, int n)
+{
+    int i;
+    unsigned left, right, last;
+
+
+    for (i = 0; i < n; i ++)
+	add(bp, q, rand() % 1000 + 1);
+
+    last = 0;
+
+    for (i = 1; i < n; i ++) {
+	left = removeMin(bp, q, &last);
+	right = removeMin(bp, q, &last);
+	add(bp, q, left + right);
+    }
+
+    removeMin(bp, q, &last);
+    return n + 3L * (n - 1) + 1;
+}
+
+
+/*
+ * Functions for each backend.  All of them hold the keys in the entry
+ * pointers except the typed queue, which holds the keys themselves.
+ */
+
+static int keycmp(void *p1, void *p2)
+{
+    return (KEY(p1) < KEY(p2)) ? -1 : (KEY(p1) > KEY(p2));
+}
+
+static unsigned key(void *p) { return KEY(p); }
+
+static void *binaryCreate(void) { return createQueue(keycmp); }
+static void *daryCreate(void) { return createDaryQueue(keycmp, 4); }
+static void pqDestroy(void *q) { destroyQueue(q); }
+static void pqAdd(void *q, unsigned k) { addEntry(q, ENTRY(k)); }
+static unsigned pqRemove(void *q) { return KEY(removeEntry(q)); }
+
+static void *typedCreate(void)
+{
+    intpq *pq = malloc(sizeof(intpq));
+    intpq_init(pq);
+    return pq;
+}
+
+static void typedDestroy(void *q) { intpq_destroy(q); free(q); }
+static void typedAdd(void *q, unsigned k) { intpq_push(q, k); }
+static unsigned typedRemove(void *q) { return intpq_pop(q); }
+
+static void *apqCreate(void) { return createAPQ(keycmp); }
+static void apqDestroy(void *q) { destroyAPQ(q); }
+static void apqAdd(void *q, unsigned k) { addAPQEntry(q, ENTRY(k)); }
+static unsigned apqRemove(void *q) { return KEY(removeAPQEntry(q)); }
+
+static void *mqCreate(void) { return createMultiQueue(keycmp, 1); }
+static void mqDestroy(void *q) { destroyMultiQueue(q); }
+static void mqAdd(void *q, unsigned k) { addMultiEntry(q, ENTRY(k)); }
+static unsigned mqRemove(void *q) { return KEY(removeMultiEntry(q)); }
+
+static void *radixCreate(void) { return createRadixHeap(key); }
+static void radixDestroy(void *q) { destroyRadixHeap(q); }
+static void radixAdd(void *q, unsigned k) { addRadixEntry(q, ENTRY(k)); }
+static unsigned radixRemove(void *q) { return KEY(removeRadixEntry(q)); }
+
+BACKEND backends[] = {
+    {"binary", binaryCreate, pqDestroy, pqAdd, pqRemove},
+    {"4-ary", daryCreate, pqDestroy, pqAdd, pqRemove},
+    {"typed", typedCreate, typedDestroy, typedAdd, typedRemove},
+    {"addressable", apqCreate, apqDestroy, apqAdd, apqRemove},
+    {"multiqueue", mqCreate, mqDestroy, mqAdd, mqRemove},
+    {"radix", radixCreate, radixDestroy, radixAdd, radixRemove},
+};
+
+WORKLOAD workloads[] = {
+    {"random", randomRun},
+    {"sorted", sortedRun},
+    {"reverse", reverseRun},
+    {"dups", dupRun},
+    {"hold", holdRun},
+    {"huffman", huffmanRun},
+};
+
+
+/*
+ * Function:	measure
+ *
+ * Description:	Run a workload on a new queue and return the number of
+ *		nanoseconds it took, storing the number of operations.
+ */
+
+static long measure(BACKEND *bp, WORKLOAD *wp, int n, long *ops)
+{
+    long start, spent;
+    void *q;
+
+
+    srand(1);
+    q = bp->create();
+    start = nanoseconds();
+    *ops = wp->run(bp, q, n);
+    spent = nanoseconds() - start;
+    bp->destroy(q);
+    return spent;
+}
+
+
+/*
+ * Function:	main
+ *
+ * Description:	Driver function for the pqbench application.
+ */
+
+int main(int argc, char *argv[])
+{
+    int b, i, w, n, opt;
+    long ops, spent;
+
+
+    n = 250000;
+
+    while ((opt = getopt(argc, argv, "n:")) != -1) {
+	if (opt == 'n' && atoi(optarg) > 0 && atoi(optarg) <= 4000000)
+	    n = atoi(optarg);
+	else {
+	    fprintf(stderr, "usage: %s [-n keys]\n", argv[0]);
+	    exit(EXIT_FAILURE);
+	}
+    }
+
+    printf("%-12s %-8s %10s %8s %8s\n", "queue", "workload", "Mops/s",
+	    "p50 ns", "p99 ns");
+
+    for (b = 0; b < sizeof(backends) / sizeof(backends[0]); b ++)
+	for (w = 0; w < sizeof(workloads) / sizeof(workloads[0]); w ++) {
+	    timed = false;
+	    spent = measure(&backends[b], &workloads[w], n, &ops);
+
+	    for (i = 0; i < NUM_BUCKETS; i ++)
+		histogram[i] = 0;
+
+	    timed = true;
+	    measure(&backends[b], &workloads[w], n, &ops);
+
+	    printf("%-12s %-8s %10.2f %8ld %8ld\n", backends[b].name,
+		    workloads[w].name, ops * 1e3 / spent, percentile(.5),
+		    percentile(.99));
+	}
+
+    exit(EXIT_SUCCESS);
+}
@@ -7,41 +7,161 @@
  * that are used in the main driver functions. The functions create and
  * manipulate the priority queue.
  *
+ * The queue is a d-ary heap: the children of entry i are entries d * i + 1
+ * through d * i + d. createQueue makes the usual binary heap, createDaryQueue
+ * lets the caller pick d. With d = 4 the heap is half as tall, and the four
+ * children that heap down compares are next to each other in memory, so each
+ * level costs one cache miss instead of one per compare. The array is placed
+ * so that each group of children starts on a multiple of d pointers, which
+ * for d = 2, 4 and 8 means a group never straddles two cache lines.
+ *
+ * The array doubles when full and halves when a quarter full, but never below
+ * the length asked for with reserveEntries. All memory comes from the
+ * allocator given to createQueueIn, so a queue can live in an arena.
+ *
  * See comments for the functions below for mode detailed desctiption for each
  * of them.
  *
  */
 
 #include "pqueue.h"
+#include "cache.h"
 #include "assert.h"
+#include "limits.h"
+#include "stdint.h"
 #include "stdio.h"
 #include "stdlib.h"
+#include "string.h"
+
+// Fewest entries the array ever has room for
+#define MIN_LENGTH 10
 
 // Defines priority queue type
 typedef struct pqueue {
   int count;
   int length;
+  int reserved; // array does not shrink below this many entries
+  int arity;    // number of children of each entry
+  void *block;  // allocated memory, data points into it
+  size_t size;  // size of block
   void **data;
   int (*compare)(void *, void *);
+  ALLOCATOR allocator;
 } PQ;
 
-// Creates priority queue and returns pointer to it. Big O complexity: O(1)
-PQ *createQueue(int (*compare)()) {
+// Default allocator callbacks, the arena is not used
+static void *defaultAlloc(void *arena, size_t size) { return malloc(size); }
+
+static void defaultRelease(void *arena, void *ptr, size_t size) { free(ptr); }
+
+static ALLOCATOR defaultAllocator = {defaultAlloc, defaultRelease, NULL};
+
+// Moves the entries into a new array with room for length entries. The first
+// child of every entry lands on a multiple of arity pointers from a cache line
+// boundary. Big O complexity: O(n), where n is the number of entries
+static void resizeData(PQ *pq, int length) {
+  // allocators only promise malloc alignment, so get an extra cache line and
+  // align by hand
+  size_t size = (length + pq->arity - 1) * sizeof(void *) + CACHE_LINE;
+  void *block = pq->allocator.alloc(pq->allocator.arena, size);
+  assert(block != NULL);
+
+  // first child of i is at d * i + 1, shifting by d - 1 makes it d * (i + 1)
+  uintptr_t base =
+      ((uintptr_t)block + CACHE_LINE - 1) & ~(uintptr_t)(CACHE_LINE - 1);
+  void **data = (void **)base + pq->arity - 1;
+
+  if (pq->block != NULL) {
+    memcpy(data, pq->data, pq->count * sizeof(void *));
+    pq->allocator.release(pq->allocator.arena, pq->block, pq->size);
+  }
+
+  pq->block = block;
+  pq->size = size;
+  pq->data = data;
+  pq->length = length;
+}
+
+// Halves the array once it is only a quarter full, but not below the reserved
+// length. Shrinking at a quarter instead of at half keeps a queue that goes up
+// and down around a power of two from resizing on every operation.
+// Big O complexity: O(1) amortized
+static void shrinkData(PQ *pq) {
+  if (pq->count < pq->length / 4 && pq->length / 2 >= pq->reserved) {
+    resizeData(pq, pq->length / 2);
+  }
+}
+
+// Moves entry down from index this, moving smaller children up into the
+// hole, and stores it where it belongs. Big O complexity: O(d log n / log d)
+static void heapDown(PQ *pq, int this, void *entry) {
+  // get index of the first child of the hole
+  int child = pq->arity * this + 1;
+
+  // go through the whole queue
+  while (child < pq->count) {
+
+    // find the smallest child, keeping the first of equal ones
+    int min = child;
+    int end = child + pq->arity < pq->count ? child + pq->arity : pq->count;
+    int i;
+    for (i = child + 1; i < end; i++) {
+      if (pq->compare(pq->data[i], pq->data[min]) < 0) {
+        min = i;
+      }
+    }
+
+    // move the smallest child up if entry is larger than it
+    if (pq->compare(entry, pq->data[min]) > 0) {
+      pq->data[this] = pq->data[min];
+
+      // update hole and its first child
+      this = min;
+      child = pq->arity * this + 1;
+
+      // if the smallest child is not smaller the heap is fine
+    } else {
+      break;
+    }
+  }
+  pq->data[this] = entry;
+}
+
+// Creates binary heap priority queue and returns pointer to it.
+// Big O complexity: O(1)
+PQ *createQueue(int (*compare)()) { return createQueueIn(compare, 2, NULL); }
+
+// Creates priority queue where each entry has arity children, at least 2, or
+// 0 to pick DEFAULT_ARITY. Returns pointer to it. Big O complexity: O(1)
+PQ *createDaryQueue(int (*compare)(), int arity) {
+  return createQueueIn(compare, arity, NULL);
+}
+
+// Creates priority queue where each entry has arity children, at least 2, or
+// 0 to pick DEFAULT_ARITY. The queue and its array get their memory from
+// allocator, or from malloc if it is NULL. Returns pointer to it.
+// Big O complexity: O(1)
+PQ *createQueueIn(int (*compare)(), int arity, ALLOCATOR *allocator) {
   // me no create compare. me assert compare
-  assert(compare != NULL);
+  assert(compare != NULL && (arity == 0 || arity >= 2));
 
-  // me malloc q. me assert q
-  PQ *q = malloc(sizeof(PQ));
+  if (allocator == NULL) {
+    allocator = &defaultAllocator;
+  }
+  assert(allocator->alloc != NULL && allocator->release != NULL);
+
+  // me allocate q. me assert q
+  PQ *q = allocator->alloc(allocator->arena, sizeof(PQ));
   assert(q != NULL);
 
   // initialize empty queue with initial length
   q->count = 0;
-  q->length = 10; // will grow if needed
+  q->reserved = MIN_LENGTH;
+  q->arity = arity > 0 ? arity : DEFAULT_ARITY;
+  q->block = NULL;
   q->compare = compare;
-
-  // me malloc array. me assert array
-  q->data = malloc(q->length * sizeof(void *));
-  assert(q->data != NULL);
+  q->allocator = *allocator;
+  resizeData(q, MIN_LENGTH); // will grow if needed
 
   return q;
 }
@@ -50,8 +170,28 @@ PQ *createQueue(int (*compare)()) {
 void destroyQueue(PQ *pq) {
   // me no create pq. me assert pq
   assert(pq != NULL);
-  free(pq->data);
-  free(pq);
+  ALLOCATOR allocator = pq->allocator;
+  allocator.release(allocator.arena, pq->block, pq->size);
+  allocator.release(allocator.arena, pq, sizeof(PQ));
+}
+
+// Makes room for at least n entries at once and keeps the array from
+// shrinking below that, so a queue of known size never reallocates.
+// Big O complexity: O(n)
+void reserveEntries(PQ *pq, int n) {
+  assert(pq != NULL && n >= 0);
+
+  // doubling past INT_MAX / 2 would overflow, so take n exactly instead
+  int length = pq->length;
+  while (length < n) {
+    length = length <= INT_MAX / 2 ? length * 2 : n;
+  }
+
+  if (length > pq->length) {
+    resizeData(pq, length);
+  }
+
+  pq->reserved = n > MIN_LENGTH ? n : MIN_LENGTH;
 }
 
 // Returns number of items in priority queue. Big O complexity: O(1)
@@ -69,38 +209,32 @@ void addEntry(PQ *pq, void *entry) {
 
   // double the size of array if needed
   if (pq->count == pq->length) {
-    pq->length *= 2;
-    pq->data = realloc(pq->data, pq->length * sizeof(void *));
-    // me allocate. me assert
-    assert(pq->data != NULL);
+    resizeData(pq, pq->length * 2);
   }
 
-  // add entry to the end of array and update count
-  pq->data[pq->count] = entry;
-  pq->count++;
-
   /*** HEAP UP ***/
-  // get index of new entry and its parent
-  int this = pq->count - 1;
-  int parent = (this - 1) / 2;
-
-  // swap new entry with its parent until either:
-  // a. new entry is root
-  // b. new entry is smaller than its parent
-  while (this > 0 && pq->compare(pq->data[this], pq->data[parent]) < 0) {
-    void *temp = pq->data[this];
+  // start with a hole at the end of array and the parent of the hole
+  int this = pq->count;
+  int parent = (this - 1) / pq->arity;
+
+  // move parents down into the hole until either:
+  // a. hole is root
+  // b. new entry is not smaller than the hole's parent
+  // then drop new entry into the hole, one write per level instead of a swap
+  while (this > 0 && pq->compare(entry, pq->data[parent]) < 0) {
     pq->data[this] = pq->data[parent];
-    pq->data[parent] = temp;
 
-    // update parent and child to swap
+    // update hole and its parent
     this = parent;
-    parent = (this - 1) / 2;
+    parent = (this - 1) / pq->arity;
   }
+  pq->data[this] = entry;
+  pq->count++;
   /*** END HEAP UP ***/
 }
 
-// Removes an entry from the priority queue. Big O complexity: O(log n), where n
-// is the number of entries in the priority queue
+// Removes an entry from the priority queue. Big O complexity: O(d log n / log
+// d), where n is the number of entries and d is the arity of the queue
 void *removeEntry(PQ *pq) {
   // me no create pq. me assert pq
   assert(pq != NULL && pq->count > 0);
@@ -108,44 +242,69 @@ void *removeEntry(PQ *pq) {
   // save root node's data to return it in the end
   void *root = pq->data[0];
 
-  // replace root's data with the last entry's data
-  pq->data[0] = pq->data[pq->count - 1];
+  // the last entry will go into the hole left at the root
   // update number of entries in array
   pq->count--;
+  void *last = pq->data[pq->count];
 
-  /*** HEAP DOWN ***/
-  // get indexes of root and its children
-  int this = 0;
-  int left = 2 * this + 1;
-  int right = 2 * this + 2;
+  // fill the hole at the root
+  heapDown(pq, 0, last);
 
-  // go through the whole queue
-  while (left < pq->count) {
+  // give memory back once the queue has drained
+  shrinkData(pq);
 
-    // check which child's data is larger: left or right
-    int max = left;
-    if (right < pq->count && pq->compare(pq->data[right], pq->data[left]) < 0) {
-      max = right;
-    }
+  return root;
+}
 
-    // compare data in parent and child. swap them if child's data is larger
-    if (pq->compare(pq->data[this], pq->data[max]) > 0) {
+// Returns the smallest entry without removing it, or NULL if the queue is
+// empty. Big O complexity: O(1)
+void *getMinEntry(PQ *pq) {
+  assert(pq != NULL);
+  return pq->count > 0 ? pq->data[0] : NULL;
+}
 
-      void *temp = pq->data[this];
-      pq->data[this] = pq->data[max];
-      pq->data[max] = temp;
+// Creates binary heap priority queue holding the n given entries. Big O
+// complexity: O(n), see addEntries
+PQ *createQueueFromArray(int (*compare)(), void **entries, int n) {
+  PQ *q = createQueue(compare);
+  addEntries(q, entries, n);
+  return q;
+}
 
-      // update parent and child nodes
-      this = max;
-      left = 2 * this + 1;
-      right = 2 * this + 2;
+// Adds n entries to the priority queue at once. When the batch is at least as
+// large as the queue, the whole array is made into a heap again from the
+// bottom up (Floyd's method), which costs O(n + m) instead of O(n log(n + m))
+// for adding the entries one at a time. A small batch is heaped up one entry
+// at a time. Big O complexity: O(n + m) or O(n log m), where m is the number
+// of entries already in the priority queue
+void addEntries(PQ *pq, void **entries, int n) {
+  assert(pq != NULL && n >= 0 && (n == 0 || entries != NULL));
 
-      // if child's data is smaller the heap is fine
-    } else {
-      break;
+  // small batch, cheaper to heap up each entry
+  if (n < pq->count) {
+    int i;
+    for (i = 0; i < n; i++) {
+      addEntry(pq, entries[i]);
     }
+    return;
   }
-  /*** END HEAP DOWN ***/
 
-  return root;
+  // grow once to fit the whole batch
+  if (pq->count + n > pq->length) {
+    assert(n <= INT_MAX - pq->count);
+    int length = pq->length;
+    while (length < pq->count + n) {
+      length = length <= INT_MAX / 2 ? length * 2 : pq->count + n;
+    }
+    resizeData(pq, length);
+  }
+
+  memcpy(pq->data + pq->count, entries, n * sizeof(void *));
+  pq->count += n;
+
+  // heap down every entry that has children, last parent first
+  int i;
+  for (i = (pq->count - 2) / pq->arity; pq->count > 1 && i >= 0; i--) {
+    heapDown(pq, i, pq->data[i]);
+  }
 }
@@ -5,16 +5,38 @@
  *
  * Description:	This file contains the public function and type
  *		declarations for a priority queue abstract data type for
- *		generic pointer types.
+ *		generic pointer types.  The queue is a heap in which
+ *		each entry has two children by default, or any number
+ *		of children chosen when the queue is created.  Entries
+ *		can be added one at a time or as a whole array.
+ *
+ *		A queue normally gets its memory from malloc.  Given an
+ *		ALLOCATOR, it instead calls ALLOC and RELEASE with the
+ *		allocator's ARENA for all of its memory, and RELEASE is
+ *		told the size that was allocated.
  */
 
 # ifndef PQUEUE_H
 # define PQUEUE_H
 
+# include <stddef.h>
+
+# define DEFAULT_ARITY 4	/* children per entry for createDaryQueue */
+
 typedef struct pqueue PQ;
 
+typedef struct allocator {
+    void *(*alloc)(void *arena, size_t size);
+    void (*release)(void *arena, void *ptr, size_t size);
+    void *arena;
+} ALLOCATOR;
+
 PQ *createQueue(int (*compare)());
 
+PQ *createDaryQueue(int (*compare)(), int arity);
+
+PQ *createQueueIn(int (*compare)(), int arity, ALLOCATOR *allocator);
+
 void destroyQueue(PQ *pq);
 
 int numEntries(PQ *pq);
@@ -23,4 +45,12 @@ void addEntry(PQ *pq, void *entry);
 
 void *removeEntry(PQ *pq);
 
+void *getMinEntry(PQ *pq);
+
+PQ *createQueueFromArray(int (*compare)(), void **entries, int n);
+
+void addEntries(PQ *pq, void **entries, int n);
+
+void reserveEntries(PQ *pq, int n);
+
 # endif /* PQUEUE_H */
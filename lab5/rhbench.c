@@ -0,0 +1,208 @@
+/*
+ * File:	rhbench.c
+ *
+ * Copyright:	2023, Vladimir Ceban
+ *
+ * Description:	Compare the radix heap in rheap.c with the binary heap in
+ *		pqueue.c on a monotone workload.  The queue is filled with
+ *		N random keys and then the hold model is run: remove the
+ *		smallest entry and add it back with a key that is larger by
+ *		a random amount less than C, as in Dijkstra's algorithm
+ *		with edge weights below C or an event simulation.  The time
+ *		per hold operation is printed for each queue size N and
+ *		increment range C, showing the size at which the radix heap
+ *		starts to win.
+ *
+ *		usage: rhbench [-n operations]
+ */
+
+# include <time.h>
+# include <stdio.h>
+# include <limits.h>
+# include <stdint.h>
+# include <stdlib.h>
+# include <unistd.h>		/* for getopt() */
+# include "pqueue.h"
+# include "rheap.h"
+
+/* Keys are stored directly in the entry pointers, starting at one since
+   the queues do not allow null pointers. */
+
+# define ENTRY(k)	((void *) (uintptr_t) (k))
+# define KEY(p)		((unsigned) (uintptr_t) (p))
+
+/* Keys grow by less than the largest range on each operation and must
+   fit in 32 bits. */
+
+# define MAX_RANGE	4096
+# define MAX_OPS	(UINT_MAX / MAX_RANGE - 1)
+
+
+/*
+ * Function:	keycmp
+ *
+ * Description:	Compare two keys as in strcmp.
+ */
+
+static int keycmp(void *p1, void *p2)
+{
+    return (KEY(p1) < KEY(p2)) ? -1 : (KEY(p1) > KEY(p2));
+}
+
+
+/*
+ * Function:	key
+ *
+ * Description:	Return the key of an entry for the radix heap.
+ */
+
+static unsigned key(void *p)
+{
+    return KEY(p);
+}
+
+
+/*
+ * Function:	nanoseconds
+ *
+ * Description:	Return the current time in nanoseconds.
+ */
+
+static double nanoseconds(void)
+{
+    struct timespec ts;
+
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+
+/*
+ * Function:	check
+ *
+ * Description:	Exit with a message if a removed key is smaller than the
+ *		key removed before it.
+ */
+
+static void check(char *name, unsigned k, unsigned last)
+{
+    if (k < last) {
+	fprintf(stderr, "%s: removed %u after %u\n", name, k, last);
+	exit(EXIT_FAILURE);
+    }
+}
+
+
+/*
+ * Function:	binary
+ *
+ * Description:	Run the hold model on a binary heap and return the time
+ *		per operation in nanoseconds.
+ */
+
+static double binary(int n, unsigned range, long ops)
+{
+    int i;
+    unsigned k, last;
+    double start, spent;
+    PQ *pq;
+
+
+    srand(1);
+    pq = createQueue(keycmp);
+
+    for (i = 0; i < n; i ++)
+	addEntry(pq, ENTRY(rand() % range + 1));
+
+    last = 0;
+    start = nanoseconds();
+
+    for (i = 0; i < ops; i ++) {
+	k = KEY(removeEntry(pq));
+	check("binary heap", k, last);
+	addEntry(pq, ENTRY(k + rand() % range));
+	last = k;
+    }
+
+    spent = nanoseconds() - start;
+    destroyQueue(pq);
+    return spent / ops;
+}
+
+
+/*
+ * Function:	radix
+ *
+ * Description:	Run the hold model on a radix heap and return the time per
+ *		operation in nanoseconds.
+ */
+
+static double radix(int n, unsigned range, long ops)
+{
+    int i;
+    unsigned k, last;
+    double start, spent;
+    RH *rh;
+
+
+    srand(1);
+    rh = createRadixHeap(key);
+
+    for (i = 0; i < n; i ++)
+	addRadixEntry(rh, ENTRY(rand() % range + 1));
+
+    last = 0;
+    start = nanoseconds();
+
+    for (i = 0; i < ops; i ++) {
+	k = KEY(removeRadixEntry(rh));
+	check("radix heap", k, last);
+	addRadixEntry(rh, ENTRY(k + rand() % range));
+	last = k;
+    }
+
+    spent = nanoseconds() - start;
+    destroyRadixHeap(rh);
+    return spent / ops;
+}
+
+
+/*
+ * Function:	main
+ *
+ * Description:	Driver function for the rhbench application.
+ */
+
+int main(int argc, char *argv[])
+{
+    int n, r, opt;
+    long ops;
+    double b, x;
+    unsigned ranges[] = {16, 256, MAX_RANGE};
+
+
+    ops = 1000000;
+
+    while ((opt = getopt(argc, argv, "n:")) != -1) {
+	if (opt == 'n' && atol(optarg) > 0 && atol(optarg) <= MAX_OPS)
+	    ops = atol(optarg);
+	else {
+	    fprintf(stderr, "usage: %s [-n operations]\n", argv[0]);
+	    exit(EXIT_FAILURE);
+	}
+    }
+
+    printf("%-8s %8s %14s %14s %8s\n", "size", "range", "binary ns/op",
+	    "radix ns/op", "speedup");
+
+    for (r = 0; r < sizeof(ranges) / sizeof(ranges[0]); r ++)
+	for (n = 1; n <= 1 << 20; n *= 4) {
+	    b = binary(n, ranges[r], ops);
+	    x = radix(n, ranges[r], ops);
+	    printf("%-8d %8u %14.1f %14.1f %7.2fx\n", n, ranges[r], b, x,
+		    b / x);
+	}
+
+    exit(EXIT_SUCCESS);
+}
@@ -0,0 +1,158 @@
+/*
+ * File: rheap.c
+ *
+ * Copyright:	2023, Vladimir Ceban
+ *
+ * Description: This file contains functions defined in rheap.h. The radix heap
+ * keeps the key of the last removed entry and puts every entry in a bucket
+ * named after the highest bit in which its key differs from that key: bucket 0
+ * holds keys equal to it, bucket b holds keys that first differ in bit b - 1.
+ * Since keys never drop below the last removed key, every key in bucket b is
+ * smaller than every key in a higher bucket, and no comparisons are needed to
+ * add an entry.
+ *
+ * To remove, an entry is taken from bucket 0 if it has any. Otherwise the
+ * lowest bucket that is not empty is scanned for its smallest key, that key
+ * becomes the last removed key, and the bucket's entries are spread over the
+ * lower buckets, where they must land since they now share more high bits
+ * with the last key. An entry only ever moves down, so it moves at most 32
+ * times over its life, making a remove O(log C) amortized, where C is the
+ * largest key.
+ *
+ */
+
+#include "rheap.h"
+#include <assert.h>
+#include <stdlib.h>
+
+// One bucket for keys equal to the last removed key and one per key bit
+#define NUM_BUCKETS 33
+
+// Defines an entry along with its key, so the key function is called once
+typedef struct slot {
+  unsigned key;
+  void *entry;
+} SLOT;
+
+// Defines a bucket of entries in no particular order
+typedef struct bucket {
+  int count;
+  int length;
+  SLOT *data;
+} BUCKET;
+
+// Defines radix heap type
+typedef struct rheap {
+  int count;
+  unsigned last; // key of the last removed entry
+  unsigned (*key)(void *);
+  BUCKET buckets[NUM_BUCKETS];
+} RH;
+
+// Returns the bucket for a key given the last removed key.
+// Big O complexity: O(1)
+static int findBucket(unsigned key, unsigned last) {
+  return key == last ? 0 : 32 - __builtin_clz(key ^ last);
+}
+
+// Appends an entry with the given key to a bucket, doubling it if needed.
+// Big O complexity: O(1) amortized
+static void pushSlot(BUCKET *bp, unsigned key, void *entry) {
+  if (bp->count == bp->length) {
+    bp->length = bp->length > 0 ? bp->length * 2 : 8;
+    bp->data = realloc(bp->data, sizeof(SLOT) * bp->length);
+    assert(bp->data != NULL);
+  }
+
+  bp->data[bp->count].key = key;
+  bp->data[bp->count].entry = entry;
+  bp->count++;
+}
+
+// Creates radix heap and returns pointer to it. Big O complexity: O(1)
+RH *createRadixHeap(unsigned (*key)()) {
+  assert(key != NULL);
+
+  RH *rh = malloc(sizeof(RH));
+  assert(rh != NULL);
+
+  rh->count = 0;
+  rh->last = 0;
+  rh->key = key;
+
+  // buckets get their arrays when first used
+  int i;
+  for (i = 0; i < NUM_BUCKETS; i++) {
+    rh->buckets[i].count = 0;
+    rh->buckets[i].length = 0;
+    rh->buckets[i].data = NULL;
+  }
+
+  return rh;
+}
+
+// Destroys radix heap, entries are not freed. Big O complexity: O(1)
+void destroyRadixHeap(RH *rh) {
+  assert(rh != NULL);
+
+  int i;
+  for (i = 0; i < NUM_BUCKETS; i++) {
+    free(rh->buckets[i].data);
+  }
+
+  free(rh);
+}
+
+// Returns number of entries in radix heap. Big O complexity: O(1)
+int numRadixEntries(RH *rh) {
+  assert(rh != NULL);
+  return rh->count;
+}
+
+// Adds an entry whose key is not smaller than the last removed key.
+// Big O complexity: O(1) amortized
+void addRadixEntry(RH *rh, void *entry) {
+  assert(rh != NULL && entry != NULL);
+
+  unsigned key = rh->key(entry);
+  assert(key >= rh->last);
+
+  pushSlot(&rh->buckets[findBucket(key, rh->last)], key, entry);
+  rh->count++;
+}
+
+// Removes an entry with the smallest key. Big O complexity: O(log C)
+// amortized, where C is the largest key
+void *removeRadixEntry(RH *rh) {
+  assert(rh != NULL && rh->count > 0);
+
+  // refill bucket 0 from the lowest bucket that is not empty
+  if (rh->buckets[0].count == 0) {
+    int b = 1;
+    while (rh->buckets[b].count == 0) {
+      b++;
+    }
+
+    // the smallest key in the bucket becomes the last removed key
+    BUCKET *bp = &rh->buckets[b];
+    unsigned min = bp->data[0].key;
+    int i;
+    for (i = 1; i < bp->count; i++) {
+      if (bp->data[i].key < min) {
+        min = bp->data[i].key;
+      }
+    }
+    rh->last = min;
+
+    // every entry moves to a lower bucket, so bp is not written to
+    for (i = 0; i < bp->count; i++) {
+      pushSlot(&rh->buckets[findBucket(bp->data[i].key, min)],
+               bp->data[i].key, bp->data[i].entry);
+    }
+    bp->count = 0;
+  }
+
+  rh->count--;
+  BUCKET *bp = &rh->buckets[0];
+  return bp->data[--bp->count].entry;
+}
@@ -0,0 +1,30 @@
+/*
+ * File:	rheap.h
+ *
+ * Copyright:	2023, Vladimir Ceban
+ *
+ * Description:	This file contains the public function and type
+ *		declarations for a radix heap, a priority queue of generic
+ *		pointer types whose priorities are unsigned integers given
+ *		by a key function.  The queue is monotone: an entry may not
+ *		be added with a key smaller than the key of the entry that
+ *		was last removed, as is the case for Dijkstra's algorithm
+ *		and for event simulation.
+ */
+
+# ifndef RHEAP_H
+# define RHEAP_H
+
+typedef struct rheap RH;
+
+RH *createRadixHeap(unsigned (*key)());
+
+void destroyRadixHeap(RH *rh);
+
+int numRadixEntries(RH *rh);
+
+void addRadixEntry(RH *rh, void *entry);
+
+void *removeRadixEntry(RH *rh);
+
+# endif /* RHEAP_H */
@@ -7,13 +7,63 @@
  *		write them in sorted order on the standard output.  The
  *		application works by inserting each integer into a priority
  *		queue ADT and then repeatedly removing the smallest value
- *		from the queue and printing it.
+ *		from the queue and printing it.  The integers are added to
+ *		the queue as one batch, which builds the heap in linear
+ *		time.
+ *
+ *		usage: sort [-d arity] [-m memory] [-f] [-v]
+ *
+ *		The -d option uses a heap with the given number of children
+ *		per entry instead of a binary heap.  The -v option reports
+ *		the time spent sorting on the standard error.
+ *
+ *		The -m option limits the memory used to about the given
+ *		number of bytes, which may end in k, m, or g, so that inputs
+ *		larger than memory can be sorted.  The input is read in runs
+ *		that fit in memory, and each run is sorted and written to a
+ *		temporary file.  The runs are then merged using a priority
+ *		queue of the runs ordered by their next integer, as many at
+ *		a time as their buffers allow, into longer runs in another
+ *		temporary file until they can all be merged at once.
+ *
+ *		The -f option skips the queue of pointers altogether: the
+ *		integers are parsed from large blocks of input into one
+ *		array, heapsorted in place by the typed heap in typedpq.h,
+ *		and formatted into large blocks of output.
  */
 
+# include <time.h>
+# include <ctype.h>
 # include <stdio.h>
 # include <stdlib.h>
 # include <assert.h>
+# include <string.h>
+# include <unistd.h>		/* for getopt() */
+# include <stdbool.h>
 # include "pqueue.h"
+# include "typedpq.h"
+
+# define MIN_LENGTH 1024	/* fewest integers in a run or run buffer */
+# define IO_BUFFER 65536	/* size of each stdio buffer we set */
+
+# define LESS(a, b)	((a) < (b))
+
+PQ_DEFINE(intpq, int, LESS)
+
+typedef struct run RUN;
+
+struct run {
+    FILE *fp;			/* temporary file holding the sorted run */
+    int *buf;			/* part of the run read in so far */
+    int pos;			/* index of the next integer in buf */
+    int count;			/* number of integers in buf */
+    long next;			/* index in the file of the next to read */
+    long end;			/* index in the file just past the run */
+};
+
+int arity = 2;
+bool fflag = false;
+bool vflag = false;
 
 
 /*
@@ -29,33 +79,536 @@ static int intcmp(int *i1, int *i2)
 
 
 /*
- * Function:	main
+ * Function:	runcmp
  *
- * Description:	Driver function for the sort application.
+ * Description:	Given pointers to two runs, compare their next integers as
+ *		in strcmp.
+ */
+
+static int runcmp(RUN *r1, RUN *r2)
+{
+    return intcmp(&r1->buf[r1->pos], &r2->buf[r2->pos]);
+}
+
+
+/*
+ * Function:	nanoseconds
+ *
+ * Description:	Return the current time in nanoseconds.
  */
 
-int main(void)
+static double nanoseconds(void)
 {
+    struct timespec ts;
+
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+
+/*
+ * Function:	parseSize
+ *
+ * Description:	Convert a number of bytes with an optional k, m, or g
+ *		suffix to a number.  Return zero if the string is invalid.
+ */
+
+static long parseSize(char *s)
+{
+    char *end;
+    long size;
+
+
+    size = strtol(s, &end, 10);
+
+    if (*end == 'k' || *end == 'K')
+	size <<= 10, end ++;
+    else if (*end == 'm' || *end == 'M')
+	size <<= 20, end ++;
+    else if (*end == 'g' || *end == 'G')
+	size <<= 30, end ++;
+
+    return *end == '\0' && size > 0 ? size : 0;
+}
+
+
+/*
+ * Function:	sortMemory
+ *
+ * Description:	Sort the whole input in memory and return the number of
+ *		integers sorted.
+ */
+
+static long sortMemory(void)
+{
+    int *p, **ints, x, i, n, length;
     PQ *pq;
-    int *p, x;
 
 
-    pq = createQueue(intcmp);
+    n = 0;
+    length = MIN_LENGTH;
+    ints = malloc(sizeof(int *) * length);
+    assert(ints != NULL);
 
     while (scanf("%d", &x) == 1) {
+	if (n == length) {
+	    length *= 2;
+	    ints = realloc(ints, sizeof(int *) * length);
+	    assert(ints != NULL);
+	}
+
 	p = malloc(sizeof(int));
 	assert(p != NULL);
 
 	*p = x;
-	addEntry(pq, p);
+	ints[n ++] = p;
+    }
+
+    pq = createDaryQueue(intcmp, arity);
+    addEntries(pq, (void **) ints, n);
+
+    for (i = 0; i < n; i ++)
+	ints[i] = removeEntry(pq);
+
+    for (i = 0; i < n; i ++) {
+	printf("%d\n", *ints[i]);
+	free(ints[i]);
+    }
+
+    free(ints);
+    destroyQueue(pq);
+    return n;
+}
+
+
+/*
+ * Function:	sortRun
+ *
+ * Description:	Sort the N integers in RUN using a priority queue of
+ *		pointers into it, and write them either to the given file
+ *		in binary or, if FP is null, to the standard output.  PTRS
+ *		must have room for N pointers.
+ */
+
+static void sortRun(int *run, int n, int **ptrs, FILE *fp)
+{
+    int i;
+    PQ *pq;
+
+
+    for (i = 0; i < n; i ++)
+	ptrs[i] = &run[i];
+
+    pq = createDaryQueue(intcmp, arity);
+    addEntries(pq, (void **) ptrs, n);
+
+    for (i = 0; i < n; i ++)
+	ptrs[i] = removeEntry(pq);
+
+    destroyQueue(pq);
+
+    for (i = 0; i < n; i ++)
+	if (fp != NULL)
+	    fwrite(ptrs[i], sizeof(int), 1, fp);
+	else
+	    printf("%d\n", *ptrs[i]);
+}
+
+
+/*
+ * Function:	fillRun
+ *
+ * Description:	Read the next part of a run from its file into its buffer,
+ *		which has room for LENGTH integers.  The runs being merged
+ *		share the file, so each read seeks to where its run left
+ *		off.
+ */
+
+static void fillRun(RUN *rp, int length)
+{
+    if (rp->end - rp->next < length)
+	length = rp->end - rp->next;
+
+    fseek(rp->fp, rp->next * sizeof(int), SEEK_SET);
+    rp->pos = 0;
+    rp->count = fread(rp->buf, sizeof(int), length, rp->fp);
+    rp->next += rp->count;
+}
+
+
+/*
+ * Function:	createTemp
+ *
+ * Description:	Create a temporary file that uses the given buffer of SIZE
+ *		bytes for stdio.
+ */
+
+static FILE *createTemp(char *buf, int size)
+{
+    FILE *fp;
+
+
+    if ((fp = tmpfile()) == NULL) {
+	perror("tmpfile");
+	exit(EXIT_FAILURE);
+    }
+
+    setvbuf(fp, buf, _IOFBF, size);
+    return fp;
+}
+
+
+/*
+ * Function:	mergeRuns
+ *
+ * Description:	Merge the runs of RLEN integers between FIRST and LAST in
+ *		the given file, using the buffers of RUNS of LENGTH
+ *		integers each, and write them either to OUT in binary or,
+ *		if OUT is null, to the standard output.  The queue holds
+ *		each run with integers left ordered by its next integer.
+ */
+
+static void mergeRuns(FILE *fp, long first, long last, long rlen, RUN *runs,
+	int length, FILE *out)
+{
+    RUN *rp;
+    PQ *pq;
+
+
+    pq = createDaryQueue(runcmp, arity);
+
+    for (rp = runs; first < last; first += rlen, rp ++) {
+	rp->fp = fp;
+	rp->next = first;
+	rp->end = last - first < rlen ? last : first + rlen;
+
+	fillRun(rp, length);
+	addEntry(pq, rp);
     }
 
     while (numEntries(pq) > 0) {
-	p = removeEntry(pq);
-	printf("%d\n", *p);
-	free(p);
+	rp = removeEntry(pq);
+
+	if (out != NULL)
+	    fwrite(&rp->buf[rp->pos ++], sizeof(int), 1, out);
+	else
+	    printf("%d\n", rp->buf[rp->pos ++]);
+
+	if (rp->pos == rp->count)
+	    fillRun(rp, length);
+
+	if (rp->count > 0)
+	    addEntry(pq, rp);
     }
 
     destroyQueue(pq);
+}
+
+
+/*
+ * Function:	sortExternal
+ *
+ * Description:	Sort the input using about MEMORY bytes and return the
+ *		number of integers sorted.  A quarter of the memory goes to
+ *		the stdio buffers of the standard input and output and of
+ *		the two temporary files.  An integer in a run costs the
+ *		integer itself plus a pointer to it in the array given to
+ *		the heap and another in the heap.
+ *
+ *		All runs are written one after another to a temporary
+ *		file, so that only two files are ever open however many
+ *		runs there are.  When merging, each run costs its buffer,
+ *		its entry in the heap, and itself, and the buffers must
+ *		hold at least MIN_LENGTH integers, which limits how many
+ *		runs are merged at once.  Each pass merges that many runs
+ *		at a time into a new file, until the runs left can be
+ *		merged to the standard output.
+ */
+
+static long sortExternal(long memory)
+{
+    int *run, **ptrs, i, n, size, length, fanin, passes;
+    long total, rlen, nruns, first, spilled;
+    char *bufs[4];
+    FILE *fp, *out;
+    RUN *runs;
+
+
+    size = memory / 16 < IO_BUFFER ? memory / 16 : IO_BUFFER;
+    size = size > BUFSIZ ? size : BUFSIZ;
+    memory = memory > 4 * size ? memory - 4 * size : 0;
+
+    for (i = 0; i < 4; i ++) {
+	bufs[i] = malloc(size);
+	assert(bufs[i] != NULL);
+    }
+
+    setvbuf(stdin, bufs[0], _IOFBF, size);
+    setvbuf(stdout, bufs[1], _IOFBF, size);
+
+    length = memory / (sizeof(int) + 2 * sizeof(int *));
+    length = length > MIN_LENGTH ? length : MIN_LENGTH;
+
+    run = malloc(sizeof(int) * length);
+    ptrs = malloc(sizeof(int *) * length);
+    assert(run != NULL && ptrs != NULL);
+
+
+    /* Sort each run and spill it to the end of the temporary file.  If
+       the whole input fits in a single run, it is simply written out. */
+
+    total = 0;
+    fp = NULL;
+
+    for (;;) {
+	for (n = 0; n < length; n ++)
+	    if (scanf("%d", &run[n]) != 1)
+		break;
+
+	total += n;
+
+	if (n == 0)
+	    break;
+
+	if (fp == NULL && n < length) {
+	    sortRun(run, n, ptrs, NULL);
+	    break;
+	}
+
+	if (fp == NULL)
+	    fp = createTemp(bufs[2], size);
+
+	sortRun(run, n, ptrs, fp);
+
+	if (n < length)
+	    break;
+    }
+
+    free(run);
+    free(ptrs);
+
+    if (fp == NULL)
+	return total;
+
+
+    /* Merge as many runs at once as the memory allows, giving the buffers
+       whatever is left over. */
+
+    rlen = length;
+    nruns = spilled = (total + rlen - 1) / rlen;
+
+    fanin = memory / (sizeof(RUN) + sizeof(RUN *) + MIN_LENGTH * sizeof(int));
+    fanin = fanin > 2 ? fanin : 2;
+    fanin = fanin < nruns ? fanin : nruns;
+
+    length = (memory / fanin - (long) (sizeof(RUN) + sizeof(RUN *))) /
+	(long) sizeof(int);
+    length = length > MIN_LENGTH ? length : MIN_LENGTH;
+
+    runs = malloc(sizeof(RUN) * fanin);
+    assert(runs != NULL);
+
+    for (i = 0; i < fanin; i ++) {
+	runs[i].buf = malloc(sizeof(int) * length);
+	assert(runs[i].buf != NULL);
+    }
+
+    for (passes = 1; nruns > fanin; passes ++) {
+	fflush(fp);
+	out = createTemp(bufs[passes % 2 + 2], size);
+
+	for (first = 0; first < total; first += rlen * fanin)
+	    mergeRuns(fp, first, total - first < rlen * fanin ? total :
+		      first + rlen * fanin, rlen, runs, length, out);
+
+	fclose(fp);
+	fp = out;
+	rlen *= fanin;
+	nruns = (total + rlen - 1) / rlen;
+    }
+
+    fflush(fp);
+    mergeRuns(fp, 0, total, rlen, runs, length, NULL);
+    fclose(fp);
+
+    for (i = 0; i < fanin; i ++)
+	free(runs[i].buf);
+
+    free(runs);
+    free(bufs[2]);
+    free(bufs[3]);
+
+    if (vflag)
+	fprintf(stderr, "merged %ld runs %d at a time in %d passes with "
+		"%d-integer buffers\n", spilled, fanin, passes, length);
+
+    return total;
+}
+
+
+/*
+ * Function:	sortFast
+ *
+ * Description:	Sort the whole input in one array of integers and return
+ *		the number of integers sorted.  The input is read in blocks
+ *		and parsed by hand, with a number split across two blocks
+ *		carried over into the next one, and the output is formatted
+ *		into blocks by hand as well.
+ */
+
+static long sortFast(void)
+{
+    char *in, *out, *p, *end, digits[12];
+    int *ints, i, j, n, length, size, left;
+    unsigned x;
+    bool negative, eof, stop;
+
+
+    n = 0;
+    stop = false;
+    length = MIN_LENGTH;
+    ints = malloc(sizeof(int) * length);
+    in = malloc(IO_BUFFER + 1);
+    out = malloc(IO_BUFFER);
+    assert(ints != NULL && in != NULL && out != NULL);
+
+
+    /* Parse each block up to its last whitespace and move the rest to the
+       front of the buffer for the next block.  At the end of the input, a
+       newline ends whatever is left.  Like scanf, the input stops at the
+       first word that is not a number, after any number it starts with. */
+
+    left = 0;
+
+    do {
+	size = left + fread(in + left, 1, IO_BUFFER - left, stdin);
+	eof = size == left;
+
+	if (eof)
+	    in[size ++] = '\n';
+
+	for (end = in + size; end > in && !isspace((unsigned char) end[-1]);
+		end --)
+	    ;
+
+	for (p = in; p < end && !stop; p ++) {
+	    if (isspace((unsigned char) *p))
+		continue;
+
+	    if ((negative = *p == '-') || *p == '+')
+		p ++;
+
+	    if (!isdigit((unsigned char) *p)) {
+		stop = true;
+		break;
+	    }
+
+	    for (x = 0; isdigit((unsigned char) *p); p ++)
+		x = x * 10 + *p - '0';
+
+	    if (n == length) {
+		length *= 2;
+		ints = realloc(ints, sizeof(int) * length);
+		assert(ints != NULL);
+	    }
+
+	    ints[n ++] = negative ? -x : x;
+	    stop = !isspace((unsigned char) *p);
+	}
+
+	left = in + size - end;
+	memmove(in, end, left);
+
+	if (left == IO_BUFFER) {
+	    fprintf(stderr, "sort: input has a %d-byte word\n", IO_BUFFER);
+	    exit(EXIT_FAILURE);
+	}
+    } while (!eof && !stop);
+
+    intpq_sort(ints, n);
+
+
+    /* Format each integer backwards into digits and copy it out. */
+
+    size = 0;
+
+    for (i = 0; i < n; i ++) {
+	if (size > IO_BUFFER - sizeof(digits)) {
+	    fwrite(out, 1, size, stdout);
+	    size = 0;
+	}
+
+	x = ints[i] < 0 ? -(unsigned) ints[i] : ints[i];
+	j = sizeof(digits);
+	digits[-- j] = '\n';
+
+	do
+	    digits[-- j] = '0' + x % 10;
+	while ((x /= 10) > 0);
+
+	if (ints[i] < 0)
+	    digits[-- j] = '-';
+
+	memcpy(out + size, digits + j, sizeof(digits) - j);
+	size += sizeof(digits) - j;
+    }
+
+    fwrite(out, 1, size, stdout);
+    free(ints);
+    free(in);
+    free(out);
+    return n;
+}
+
+
+/*
+ * Function:	main
+ *
+ * Description:	Driver function for the sort application.
+ */
+
+int main(int argc, char *argv[])
+{
+    int opt;
+    long n, memory;
+    double start;
+
+
+    memory = 0;
+
+    while ((opt = getopt(argc, argv, "d:m:fv")) != -1) {
+	if (opt == 'd' && atoi(optarg) > 1)
+	    arity = atoi(optarg);
+	else if (opt == 'm' && parseSize(optarg) > 0)
+	    memory = parseSize(optarg);
+	else if (opt == 'f')
+	    fflag = true;
+	else if (opt == 'v')
+	    vflag = true;
+	else {
+	    fprintf(stderr, "usage: %s [-d arity] [-m memory] [-f] [-v]\n",
+		    argv[0]);
+	    exit(EXIT_FAILURE);
+	}
+    }
+
+    if (fflag || memory == 0)
+	setvbuf(stdout, NULL, _IOFBF, IO_BUFFER);
+
+    start = nanoseconds();
+
+    if (fflag)
+	n = sortFast();
+    else
+	n = memory > 0 ? sortExternal(memory) : sortMemory();
+
+    if (vflag && n > 0 && fflag)
+	fprintf(stderr, "typed heapsort: %ld elements, %.1f ns/element\n",
+		n, (nanoseconds() - start) / n);
+    else if (vflag && n > 0)
+	fprintf(stderr, "%d-ary heap: %ld elements, %.1f ns/element\n",
+		arity, n, (nanoseconds() - start) / n);
+
     exit(EXIT_SUCCESS);
 }
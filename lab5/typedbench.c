@@ -0,0 +1,166 @@
+/*
+ * File:	typedbench.c
+ *
+ * Copyright:	2023, Vladimir Ceban
+ *
+ * Description:	Compare the generic priority queue in pqueue.c with the
+ *		typed queue from typedpq.h on the workload of sort.c: add
+ *		a sequence of random integers to the queue, then remove
+ *		them all in order.  The generic queue holds pointers to the
+ *		integers and calls intcmp through a pointer, the typed
+ *		queue holds the integers themselves and inlines the
+ *		comparison.  The time per element is printed for each.
+ *
+ *		usage: typedbench [count]
+ */
+
+# include <time.h>
+# include <stdio.h>
+# include <stdlib.h>
+# include <assert.h>
+# include "pqueue.h"
+# include "typedpq.h"
+
+# define LESS(a, b)	((a) < (b))
+
+PQ_DEFINE_ARITY(intpq2, int, LESS, 2)
+PQ_DEFINE(intpq4, int, LESS)
+
+
+/*
+ * Function:	intcmp
+ *
+ * Description:	Given pointers to two integers, compare them as in strcmp.
+ */
+
+static int intcmp(int *i1, int *i2)
+{
+    return (*i1 < *i2) ? -1 : (*i1 > *i2);
+}
+
+
+/*
+ * Function:	nanoseconds
+ *
+ * Description:	Return the current time in nanoseconds.
+ */
+
+static double nanoseconds(void)
+{
+    struct timespec ts;
+
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+
+/*
+ * Function:	report
+ *
+ * Description:	Check that the output is sorted and print the time taken.
+ */
+
+static void report(char *name, int *out, int n, double ns)
+{
+    int i;
+
+
+    for (i = 1; i < n; i ++)
+	if (out[i - 1] > out[i]) {
+	    fprintf(stderr, "%s: output is not sorted\n", name);
+	    exit(EXIT_FAILURE);
+	}
+
+    printf("%-16s %8.1f ns/element\n", name, ns / n);
+}
+
+
+/*
+ * Function:	generic
+ *
+ * Description:	Sort the integers with the generic queue of given arity.
+ */
+
+static void generic(char *name, int *in, int *out, int n, int arity)
+{
+    int i;
+    double start;
+    PQ *pq;
+
+
+    start = nanoseconds();
+    pq = createDaryQueue(intcmp, arity);
+
+    for (i = 0; i < n; i ++)
+	addEntry(pq, &in[i]);
+
+    for (i = 0; i < n; i ++)
+	out[i] = *(int *) removeEntry(pq);
+
+    destroyQueue(pq);
+    report(name, out, n, nanoseconds() - start);
+}
+
+
+/*
+ * Function:	main
+ *
+ * Description:	Driver function for the typedbench application.
+ */
+
+int main(int argc, char *argv[])
+{
+    int i, n, *in, *out;
+    double start;
+    intpq2 pq2;
+    intpq4 pq4;
+
+
+    n = argc > 1 ? atoi(argv[1]) : 10000000;
+
+    if (n <= 0) {
+	fprintf(stderr, "usage: %s [count]\n", argv[0]);
+	exit(EXIT_FAILURE);
+    }
+
+    in = malloc(sizeof(int) * n);
+    out = malloc(sizeof(int) * n);
+    assert(in != NULL && out != NULL);
+
+    srand(1);
+
+    for (i = 0; i < n; i ++)
+	in[i] = rand();
+
+    generic("generic 2-ary", in, out, n, 2);
+    generic("generic 4-ary", in, out, n, 4);
+
+    start = nanoseconds();
+    intpq2_init(&pq2);
+
+    for (i = 0; i < n; i ++)
+	intpq2_push(&pq2, in[i]);
+
+    for (i = 0; i < n; i ++)
+	out[i] = intpq2_pop(&pq2);
+
+    intpq2_destroy(&pq2);
+    report("typed 2-ary", out, n, nanoseconds() - start);
+
+    start = nanoseconds();
+    intpq4_init(&pq4);
+
+    for (i = 0; i < n; i ++)
+	intpq4_push(&pq4, in[i]);
+
+    for (i = 0; i < n; i ++)
+	out[i] = intpq4_pop(&pq4);
+
+    intpq4_destroy(&pq4);
+    report("typed 4-ary", out, n, nanoseconds() - start);
+
+    free(in);
+    free(out);
+    exit(EXIT_SUCCESS);
+}
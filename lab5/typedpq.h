@@ -0,0 +1,190 @@
+/*
+ * File:	typedpq.h
+ *
+ * Copyright:	2023, Vladimir Ceban
+ *
+ * Description:	This file contains a macro that defines a priority queue
+ *		for one particular key type.  Unlike the queue in
+ *		pqueue.h, the keys are stored in the array itself and the
+ *		comparison is a macro or function known at compile time,
+ *		so the compiler can inline it instead of calling through
+ *		a pointer for every comparison.
+ *
+ *		PQ_DEFINE(name, type, less) defines the type NAME and the
+ *		functions below, where LESS(a, b) is true if key A should
+ *		come out of the queue before key B:
+ *
+ *		void name_init(name *pq);
+ *		void name_destroy(name *pq);
+ *		int name_size(name *pq);
+ *		void name_push(name *pq, type key);
+ *		type name_top(name *pq);
+ *		type name_pop(name *pq);
+ *		void name_pushAll(name *pq, type *keys, int n);
+ *		void name_reserve(name *pq, int length);
+ *		void name_sort(type *keys, int n);
+ *
+ *		name_sort does not use a queue at all: it heapsorts the N
+ *		keys in place, so that they end up in the order in which
+ *		they would come out of the queue.  The heap it builds has
+ *		the last key to come out on top, which is then swapped to
+ *		the end of the shrinking heap.
+ *
+ *		PQ_DEFINE_ARITY does the same for a heap with the given
+ *		number of children per entry; PQ_DEFINE uses four, like
+ *		createDaryQueue in pqueue.h.
+ */
+
+# ifndef TYPEDPQ_H
+# define TYPEDPQ_H
+
+# include <assert.h>
+# include <stdlib.h>
+# include <string.h>
+
+# define PQ_DEFINE(name, type, less) PQ_DEFINE_ARITY(name, type, less, 4)
+
+# define PQ_DEFINE_ARITY(name, type, less, arity)			      \
+									      \
+typedef struct name {							      \
+    int count;								      \
+    int length;								      \
+    type *data;								      \
+} name;									      \
+									      \
+static inline void name##_init(name *pq)				      \
+{									      \
+    pq->count = 0;							      \
+    pq->length = 10;							      \
+    pq->data = malloc(sizeof(type) * pq->length);			      \
+    assert(pq->data != NULL);						      \
+}									      \
+									      \
+static inline void name##_destroy(name *pq)				      \
+{									      \
+    free(pq->data);							      \
+}									      \
+									      \
+static inline int name##_size(name *pq)					      \
+{									      \
+    return pq->count;							      \
+}									      \
+									      \
+static inline void name##_reserve(name *pq, int length)			      \
+{									      \
+    if (length > pq->length) {						      \
+	while (pq->length < length)					      \
+	    pq->length *= 2;						      \
+									      \
+	pq->data = realloc(pq->data, sizeof(type) * pq->length);	      \
+	assert(pq->data != NULL);					      \
+    }									      \
+}									      \
+									      \
+static inline void name##_down(name *pq, int this, type key)		      \
+{									      \
+    int i, min, end, child;						      \
+									      \
+    while ((child = (arity) * this + 1) < pq->count) {			      \
+	min = child;							      \
+	end = child + (arity) < pq->count ? child + (arity) : pq->count;     \
+									      \
+	for (i = child + 1; i < end; i ++)				      \
+	    if (less(pq->data[i], pq->data[min]))			      \
+		min = i;						      \
+									      \
+	if (!less(pq->data[min], key))					      \
+	    break;							      \
+									      \
+	pq->data[this] = pq->data[min];					      \
+	this = min;							      \
+    }									      \
+									      \
+    pq->data[this] = key;						      \
+}									      \
+									      \
+static inline void name##_push(name *pq, type key)			      \
+{									      \
+    int this, parent;							      \
+									      \
+    name##_reserve(pq, pq->count + 1);					      \
+    this = pq->count ++;						      \
+									      \
+    while (this > 0 && less(key, pq->data[parent = (this - 1) / (arity)])) { \
+	pq->data[this] = pq->data[parent];				      \
+	this = parent;							      \
+    }									      \
+									      \
+    pq->data[this] = key;						      \
+}									      \
+									      \
+static inline type name##_top(name *pq)					      \
+{									      \
+    assert(pq->count > 0);						      \
+    return pq->data[0];							      \
+}									      \
+									      \
+static inline type name##_pop(name *pq)					      \
+{									      \
+    type top;								      \
+									      \
+    assert(pq->count > 0);						      \
+    top = pq->data[0];							      \
+    pq->count --;							      \
+									      \
+    if (pq->count > 0)							      \
+	name##_down(pq, 0, pq->data[pq->count]);			      \
+									      \
+    return top;								      \
+}									      \
+									      \
+static inline void name##_pushAll(name *pq, type *keys, int n)		      \
+{									      \
+    int i;								      \
+									      \
+    name##_reserve(pq, pq->count + n);					      \
+    memcpy(pq->data + pq->count, keys, sizeof(type) * n);		      \
+    pq->count += n;							      \
+									      \
+    for (i = (pq->count - 2) / (arity); pq->count > 1 && i >= 0; i --)	      \
+	name##_down(pq, i, pq->data[i]);				      \
+}									      \
+									      \
+static inline void name##_sift(type *keys, int n, int this, type key)	      \
+{									      \
+    int max, end, child;						      \
+									      \
+    while ((child = (arity) * this + 1) < n) {				      \
+	max = child;							      \
+	end = child + (arity) < n ? child + (arity) : n;		      \
+									      \
+	while (++ child < end)						      \
+	    if (less(keys[max], keys[child]))				      \
+		max = child;						      \
+									      \
+	if (!less(key, keys[max]))					      \
+	    break;							      \
+									      \
+	keys[this] = keys[max];						      \
+	this = max;							      \
+    }									      \
+									      \
+    keys[this] = key;							      \
+}									      \
+									      \
+static inline void name##_sort(type *keys, int n)			      \
+{									      \
+    int i;								      \
+    type key;								      \
+									      \
+    for (i = (n - 2) / (arity); n > 1 && i >= 0; i --)			      \
+	name##_sift(keys, n, i, keys[i]);				      \
+									      \
+    while (-- n > 0) {							      \
+	key = keys[n];							      \
+	keys[n] = keys[0];						      \
+	name##_sift(keys, n, 0, key);					      \
+    }									      \
+}
+
+# endif /* TYPEDPQ_H */
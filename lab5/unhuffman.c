@@ -0,0 +1,122 @@
+/*
+ * File:	unhuffman.c
+ *
+ * Copyright:	2023, Vladimir Ceban
+ *
+ * Description:	Restore a file compressed by the huffman application,
+ *		either in the format of pack.c or as a stream of blocks,
+ *		which is told apart by the second byte of the file.  A
+ *		missing file name or "-" means the standard input or
+ *		output.  With -j, the blocks of a stream are decoded by the
+ *		given number of threads.
+ *
+ *		usage: unhuffman [-j threads] [packed-file [output-file]]
+ */
+
+# include <stdio.h>
+# include <errno.h>
+# include <stdlib.h>
+# include <string.h>
+# include <unistd.h>
+# include "block.h"
+# include "unpack.h"
+
+
+/*
+ * Function:	openFile
+ *
+ * Description:	Open the named file, or return the given standard stream
+ *		if there is no name or it is "-".
+ */
+
+static FILE *openFile(char *name, char *mode, FILE *std)
+{
+    FILE *fp;
+
+
+    if (name == NULL || strcmp(name, "-") == 0)
+	return std;
+
+    if ((fp = fopen(name, mode)) == NULL) {
+	perror(name);
+	exit(errno);
+    }
+
+    return fp;
+}
+
+
+/*
+ * Function:	usage
+ *
+ * Description:	Print how to use the program and exit.
+ */
+
+static void usage(char *name)
+{
+    fprintf(stderr, "usage: %s [-j threads] [packed-file [output-file]]\n",
+	    name);
+    exit(EXIT_FAILURE);
+}
+
+
+/*
+ * Function:	main
+ *
+ * Description:	Driver function for the unhuffman application.
+ */
+
+int main(int argc, char *argv[])
+{
+    int magic, opt, threads = 1;
+    char *name = argv[0];
+    bool ok;
+    FILE *in, *out;
+
+
+    while ((opt = getopt(argc, argv, "j:")) != -1) {
+	if (opt != 'j')
+	    usage(name);
+
+	threads = atoi(optarg);
+
+	if (threads < 1 || threads > MAX_THREADS) {
+	    fprintf(stderr, "%s: threads must be 1 to %d\n", name, MAX_THREADS);
+	    exit(EXIT_FAILURE);
+	}
+    }
+
+    argc -= optind - 1;
+    argv += optind - 1;
+
+    if (argc > 3)
+	usage(name);
+
+    in = openFile(argc > 1 ? argv[1] : NULL, "rb", stdin);
+    out = openFile(argc > 2 ? argv[2] : NULL, "wb", stdout);
+
+    if (getc(in) != 037)
+	magic = EOF;
+    else
+	magic = getc(in);
+
+    if (magic == STREAM_MAGIC)
+	ok = decompressStream(in, out, threads);
+    else if (magic == 036)
+	ok = unpackFile(in, out);
+    else
+	ok = false;
+
+    if (!ok) {
+	fprintf(stderr, "%s: not a packed file or corrupted\n",
+		argc > 1 ? argv[1] : "stdin");
+	exit(EXIT_FAILURE);
+    }
+
+    if (fclose(out) != 0) {
+	perror(argc > 2 ? argv[2] : "stdout");
+	exit(errno);
+    }
+
+    exit(EXIT_SUCCESS);
+}
@@ -0,0 +1,175 @@
+/*
+ * File:	unpack.c
+ *
+ * Copyright:	2023, Vladimir Ceban
+ *
+ * Description:	Undo pack.c.  A packed file starts with 037 036, the size
+ *		of the original file in four bytes with the most
+ *		significant first, and the length MAXLEV of the longest
+ *		code.  Next comes the number of codes of each length from 1
+ *		to MAXLEV, where the last count is two less than the real
+ *		one, and then the bytes with codes ordered by the length of
+ *		their code.  The end of file symbol is not in the list; its
+ *		code is always one of the longest.  The codes themselves
+ *		follow, most significant bit first.
+ */
+
+# include <stdio.h>
+# include <errno.h>
+# include <assert.h>
+# include <stdlib.h>
+# include "decode.h"
+# include "unpack.h"
+
+# define END END_SYMBOL
+# define MAX_LEVELS MAX_CODE_LENGTH
+
+
+/*
+ * Function:	corrupt
+ *
+ * Description:	Report that the input is not a valid packed file and exit.
+ */
+
+static void corrupt(char *infile)
+{
+    fprintf(stderr, "%s: not a packed file or corrupted\n", infile);
+    exit(EXIT_FAILURE);
+}
+
+
+/*
+ * Function:	decodePacked
+ *
+ * Description:	Decode the packed file from P to END, which starts just
+ *		after 037 036, and write it out.  Return false if it is
+ *		corrupted.
+ */
+
+static bool decodePacked(unsigned char *p, unsigned char *end, FILE *out)
+{
+    unsigned char *counts, *text;
+    int i, c, n, maxlev, length[END + 1];
+    long size;
+    bool ok;
+    BITREADER br;
+    DECODER *dp;
+
+
+    /* Read the header and rebuild the length of every code. */
+
+    if (end - p < 5)
+	return false;
+
+    size = (long) p[0] << 24 | p[1] << 16 | p[2] << 8 | p[3];
+    maxlev = p[4];
+    p += 5;
+
+    if (maxlev < 1 || maxlev > MAX_LEVELS || end - p < maxlev)
+	return false;
+
+    for (c = 0; c <= END; c ++)
+	length[c] = 0;
+
+    length[END] = maxlev;
+
+    counts = p;
+    p += maxlev;
+
+    for (i = 1; i <= maxlev; i ++)
+	for (n = counts[i - 1] + (i == maxlev); n > 0; n --) {
+	    if (p == end || length[*p] != 0)
+		return false;
+
+	    length[*p ++] = i;
+	}
+
+    if ((dp = createDecoder(length)) == NULL)
+	return false;
+
+
+    /* Decode the text and write it out. */
+
+    text = malloc(size > 0 ? size : 1);
+    assert(text != NULL);
+
+    initReader(&br, p, end - p);
+    ok = decodeBytes(dp, &br, text, size) == size;
+
+    if (ok)
+	fwrite(text, 1, size, out);
+
+    destroyDecoder(dp);
+    free(text);
+    return ok;
+}
+
+
+/*
+ * Function:	unpackFile
+ *
+ * Description:	Read the rest of a packed file whose first two bytes have
+ *		been read, and write the original file.  Return false if
+ *		it is corrupted.
+ */
+
+bool unpackFile(FILE *in, FILE *out)
+{
+    unsigned char *data;
+    long n, length;
+    bool ok;
+
+
+    /* Read the whole file, which may be a pipe. */
+
+    n = 0;
+    length = 65536;
+    data = malloc(length);
+    assert(data != NULL);
+
+    while ((n += fread(data + n, 1, length - n, in)) == length) {
+	length *= 2;
+	data = realloc(data, length);
+	assert(data != NULL);
+    }
+
+    ok = decodePacked(data, data + n, out);
+    free(data);
+    return ok;
+}
+
+
+/*
+ * Function:	unpack
+ *
+ * Description:	Restore the file packed in INFILE to OUTFILE.
+ */
+
+void unpack(char *infile, char *outfile)
+{
+    FILE *in, *out;
+
+
+    if ((in = fopen(infile, "rb")) == NULL) {
+	perror(infile);
+	exit(errno);
+    }
+
+    if (getc(in) != 037 || getc(in) != 036)
+	corrupt(infile);
+
+    if ((out = fopen(outfile, "wb")) == NULL) {
+	perror(outfile);
+	exit(errno);
+    }
+
+    if (!unpackFile(in, out))
+	corrupt(infile);
+
+    if (fclose(out) != 0) {
+	perror(outfile);
+	exit(errno);
+    }
+
+    fclose(in);
+}
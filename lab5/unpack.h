@@ -0,0 +1,17 @@
+/*
+ * File:	unpack.h
+ *
+ * Copyright:	2023, Vladimir Ceban
+ */
+
+# ifndef UNPACK_H
+# define UNPACK_H
+
+# include <stdio.h>
+# include <stdbool.h>
+
+void unpack(char *infile, char *outfile);
+
+bool unpackFile(FILE *in, FILE *out);
+
+# endif /* UNPACK_H */
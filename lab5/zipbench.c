@@ -0,0 +1,357 @@
+/*
+ * File:	zipbench.c
+ *
+ * Copyright:	2023, Vladimir Ceban
+ *
+ * Description:	Measure the compressors against each other.  Every file
+ *		given is compressed and decompressed by each format of
+ *		huffman, and by gzip and zstd if they can be found in the
+ *		PATH.  Each program is run as its own process, so that
+ *		its time includes reading and writing the files, and its
+ *		peak memory is taken from wait4.  The output must match the
+ *		input exactly.  The best time of the given number of runs
+ *		is kept, and a table of the ratio, the speed of both
+ *		directions in MB/s of input, and the peak memory in MB is
+ *		printed, and also written as CSV if a file is given.
+ *
+ *		usage: zipbench [-r runs] [-c csv-file] file...
+ */
+
+# define _DEFAULT_SOURCE	/* for wait4() */
+# include <time.h>
+# include <fcntl.h>
+# include <stdio.h>
+# include <errno.h>
+# include <stdlib.h>
+# include <string.h>
+# include <unistd.h>
+# include <stdbool.h>
+# include <sys/stat.h>
+# include <sys/wait.h>
+# include <sys/resource.h>
+
+# define MAX_ARGS 8
+# define IO_BUFFER 65536
+
+typedef struct codec {
+    char *name;
+    char *compress[MAX_ARGS];		/* "%in" and "%out" are replaced */
+    char *decompress[MAX_ARGS];		/* by the names of the files */
+} CODEC;
+
+static CODEC codecs[] = {
+    {"huffman", {"./huffman", "%in", "%out"}, {"./unhuffman", "%in", "%out"}},
+    {"huffman -s", {"./huffman", "-s"}, {"./unhuffman"}},
+    {"huffman -4", {"./huffman", "-4"}, {"./unhuffman"}},
+    {"huffman -a", {"./huffman", "-a"}, {"./unhuffman"}},
+    {"gzip", {"gzip", "-c"}, {"gzip", "-dc"}},
+    {"zstd", {"zstd", "-q", "-c"}, {"zstd", "-q", "-dc"}},
+};
+
+# define NUM_CODECS (sizeof(codecs) / sizeof(codecs[0]))
+
+typedef struct result {
+    double seconds;			/* best wall clock time */
+    long memory;			/* peak resident set in kilobytes */
+} RESULT;
+
+
+/*
+ * Function:	nanoseconds
+ *
+ * Description:	Return the current time in nanoseconds.
+ */
+
+static double nanoseconds(void)
+{
+    struct timespec ts;
+
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+
+/*
+ * Function:	findProgram
+ *
+ * Description:	Return whether the program can be run, either as a path
+ *		or by looking for it in the PATH.
+ */
+
+static bool findProgram(char *name)
+{
+    char *path, *dir, buf[4096];
+
+
+    if (strchr(name, '/') != NULL)
+	return access(name, X_OK) == 0;
+
+    if ((path = getenv("PATH")) == NULL)
+	return false;
+
+    path = strdup(path);
+
+    for (dir = strtok(path, ":"); dir != NULL; dir = strtok(NULL, ":")) {
+	snprintf(buf, sizeof(buf), "%s/%s", dir, name);
+
+	if (access(buf, X_OK) == 0)
+	    break;
+    }
+
+    free(path);
+    return dir != NULL;
+}
+
+
+/*
+ * Function:	runProgram
+ *
+ * Description:	Run a program with the given arguments, replacing "%in"
+ *		and "%out" by the names of the files.  The standard input
+ *		is read from the input file unless it is named, and the
+ *		standard output goes to the output file unless it is
+ *		named.  Add its time and peak memory to the result, and
+ *		return whether it succeeded.
+ */
+
+static bool runProgram(char *args[], char *in, char *out, RESULT *rp)
+{
+    char *argv[MAX_ARGS + 1];
+    int i, status, input, output;
+    bool named[2] = {false, false};
+    struct rusage usage;
+    double start;
+    pid_t pid;
+
+
+    for (i = 0; args[i] != NULL; i ++) {
+	if (strcmp(args[i], "%in") == 0) {
+	    argv[i] = in;
+	    named[0] = true;
+	} else if (strcmp(args[i], "%out") == 0) {
+	    argv[i] = out;
+	    named[1] = true;
+	} else
+	    argv[i] = args[i];
+    }
+
+    argv[i] = NULL;
+    start = nanoseconds();
+
+    if ((pid = fork()) == 0) {
+	input = open(named[0] ? "/dev/null" : in, O_RDONLY);
+	output = named[1] ? open("/dev/null", O_WRONLY) :
+	    open(out, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+
+	if (input < 0 || output < 0)
+	    _exit(127);
+
+	dup2(input, 0);
+	dup2(output, 1);
+	execvp(argv[0], argv);
+	_exit(127);
+    }
+
+    if (pid < 0 || wait4(pid, &status, 0, &usage) < 0) {
+	perror(argv[0]);
+	exit(EXIT_FAILURE);
+    }
+
+    start = (nanoseconds() - start) / 1e9;
+
+    if (rp->seconds == 0 || start < rp->seconds)
+	rp->seconds = start;
+
+    if (usage.ru_maxrss > rp->memory)
+	rp->memory = usage.ru_maxrss;
+
+    return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+
+/*
+ * Function:	sameFiles
+ *
+ * Description:	Return whether two files have the same contents.
+ */
+
+static bool sameFiles(char *name1, char *name2)
+{
+    static char buf1[IO_BUFFER], buf2[IO_BUFFER];
+    FILE *fp1, *fp2;
+    size_t n1, n2;
+    bool same;
+
+
+    fp1 = fopen(name1, "rb");
+    fp2 = fopen(name2, "rb");
+    same = fp1 != NULL && fp2 != NULL;
+
+    while (same) {
+	n1 = fread(buf1, 1, sizeof(buf1), fp1);
+	n2 = fread(buf2, 1, sizeof(buf2), fp2);
+	same = n1 == n2 && memcmp(buf1, buf2, n1) == 0;
+
+	if (n1 == 0)
+	    break;
+    }
+
+    if (fp1 != NULL)
+	fclose(fp1);
+
+    if (fp2 != NULL)
+	fclose(fp2);
+
+    return same;
+}
+
+
+/*
+ * Function:	fileSize
+ *
+ * Description:	Return the size of the named file.
+ */
+
+static long fileSize(char *name)
+{
+    struct stat buf;
+
+
+    if (stat(name, &buf) != 0) {
+	perror(name);
+	exit(errno);
+    }
+
+    return buf.st_size;
+}
+
+
+/*
+ * Function:	tempFile
+ *
+ * Description:	Create a temporary file from the template and return its
+ *		name.
+ */
+
+static char *tempFile(char *template)
+{
+    char *dir, *name;
+    int fd;
+
+
+    if ((dir = getenv("TMPDIR")) == NULL)
+	dir = "/tmp";
+
+    name = malloc(strlen(dir) + strlen(template) + 2);
+    sprintf(name, "%s/%s", dir, template);
+
+    if ((fd = mkstemp(name)) < 0) {
+	perror(name);
+	exit(errno);
+    }
+
+    close(fd);
+    return name;
+}
+
+
+/*
+ * Function:	main
+ *
+ * Description:	Driver function for the zipbench application.
+ */
+
+int main(int argc, char *argv[])
+{
+    int c, i, j, opt, runs = 3;
+    char *packed, *unpacked, *base;
+    bool found[NUM_CODECS], ok;
+    long size, packedSize;
+    RESULT comp, decomp;
+    FILE *csv = NULL;
+    double mb;
+
+
+    while ((opt = getopt(argc, argv, "r:c:")) != -1) {
+	if (opt == 'r' && (runs = atoi(optarg)) > 0)
+	    continue;
+
+	if (opt == 'c' && (csv = fopen(optarg, "w")) != NULL)
+	    continue;
+
+	if (opt == 'c')
+	    perror(optarg);
+
+	fprintf(stderr, "usage: %s [-r runs] [-c csv-file] file...\n",
+		argv[0]);
+	exit(EXIT_FAILURE);
+    }
+
+    packed = tempFile("zipbenchXXXXXX");
+    unpacked = tempFile("zipbenchXXXXXX");
+
+    for (c = 0; c < NUM_CODECS; c ++)
+	if (!(found[c] = findProgram(codecs[c].compress[0])))
+	    printf("%s not found, skipped\n", codecs[c].name);
+
+    printf("%-26s %-12s %10s %7s %8s %8s %7s %7s\n", "file", "format",
+	   "bytes", "ratio", "comp", "decomp", "comp", "decomp");
+    printf("%-26s %-12s %10s %7s %8s %8s %7s %7s\n", "", "", "", "",
+	   "MB/s", "MB/s", "MB", "MB");
+
+    if (csv != NULL)
+	fprintf(csv, "file,format,size,compressed,ratio,compress_mbs,"
+		"decompress_mbs,compress_rss_kb,decompress_rss_kb\n");
+
+    for (i = optind; i < argc; i ++) {
+	size = fileSize(argv[i]);
+	mb = size / 1e6;
+
+	base = strrchr(argv[i], '/');
+	base = base != NULL ? base + 1 : argv[i];
+
+	for (c = 0; c < NUM_CODECS; c ++) {
+	    if (!found[c])
+		continue;
+
+	    memset(&comp, 0, sizeof(RESULT));
+	    memset(&decomp, 0, sizeof(RESULT));
+	    ok = true;
+
+	    for (j = 0; j < runs && ok; j ++) {
+		ok = runProgram(codecs[c].compress, argv[i], packed, &comp) &&
+		    runProgram(codecs[c].decompress, packed, unpacked,
+			       &decomp) && sameFiles(argv[i], unpacked);
+	    }
+
+	    if (!ok) {
+		printf("%-26s %-12s failed\n", base, codecs[c].name);
+		continue;
+	    }
+
+	    packedSize = fileSize(packed);
+
+	    printf("%-26s %-12s %10ld %7.3f %8.1f %8.1f %7.1f %7.1f\n",
+		   base, codecs[c].name, packedSize, (double) size /
+		   packedSize, mb / comp.seconds, mb / decomp.seconds,
+		   comp.memory / 1024.0, decomp.memory / 1024.0);
+
+	    if (csv != NULL)
+		fprintf(csv, "%s,%s,%ld,%ld,%.4f,%.2f,%.2f,%ld,%ld\n", base,
+			codecs[c].name, size, packedSize, (double) size /
+			packedSize, mb / comp.seconds, mb / decomp.seconds,
+			comp.memory, decomp.memory);
+	}
+    }
+
+    remove(packed);
+    remove(unpacked);
+
+    if (csv != NULL && fclose(csv) != 0) {
+	perror("csv");
+	exit(EXIT_FAILURE);
+    }
+
+    exit(EXIT_SUCCESS);
+}
@@ -0,0 +1,19 @@
+/*
+ * File:	cache.h
+ *
+ * Copyright:	2023, Vladimir Ceban
+ *
+ * Description:	This file defines the size of a cache line on the machines
+ *		we care about.  Fields written by different threads are
+ *		aligned to CACHE_LINE so that they never share a line.
+ *		Since malloc does not promise more than 16 byte alignment,
+ *		a structure with such fields must come from aligned_alloc
+ *		with CACHE_LINE as its alignment.
+ */
+
+# ifndef CACHE_H
+# define CACHE_H
+
+# define CACHE_LINE 64
+
+# endif /* CACHE_H */
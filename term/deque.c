@@ -0,0 +1,177 @@
+/*
+ * File: deque.c
+ *
+ * Copyright:	2023, Vladimir Ceban
+ *
+ * Description: This file contains functions defined in deque.h. It follows
+ * "Correct and Efficient Work-Stealing for Weak Memory Models" by Le, Pop,
+ * Cohen and Zappa Nardelli, which is the Chase-Lev deque written with C11
+ * atomics.
+ *
+ * The items live in a circular array indexed by two counters that only ever
+ * grow: top is where thieves take from and bottom is where the owner adds and
+ * removes. When the array is full the owner copies it into one twice as long.
+ * A thief may still be reading from the old array at that moment, so old
+ * arrays are kept in a list and only freed when the deque is destroyed.
+ *
+ */
+
+#include "deque.h"
+#include "cache.h"
+#include "list.h"
+#include <assert.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+
+// defines circular array, length is always a power of two
+typedef struct array {
+  long length;
+  _Atomic(void *) data[];
+} ARRAY;
+
+// defines deque
+typedef struct deque {
+  // written by thieves
+  _Alignas(CACHE_LINE) atomic_long top;
+  // written by owner only
+  _Alignas(CACHE_LINE) atomic_long bottom;
+  _Atomic(ARRAY *) array;
+  LIST *old; // arrays replaced by growArray
+} DEQUE;
+
+// creates an empty array of given length
+// Big O complexity: O(1)
+static ARRAY *createArray(long length) {
+  ARRAY *ap = malloc(sizeof(ARRAY) + sizeof(void *) * length);
+  assert(ap != NULL);
+  ap->length = length;
+  return ap;
+}
+
+// copies items between top and bottom into an array twice as long
+// Big O complexity: O(n), where n is the number of items
+static ARRAY *growArray(DEQUE *dp, ARRAY *ap, long top, long bottom) {
+  ARRAY *new = createArray(ap->length * 2);
+  long i;
+
+  for (i = top; i < bottom; i++) {
+    void *item = atomic_load_explicit(&ap->data[i & (ap->length - 1)],
+                                      memory_order_relaxed);
+    atomic_store_explicit(&new->data[i & (new->length - 1)], item,
+                          memory_order_relaxed);
+  }
+
+  // thieves may still hold a pointer to the old array
+  addLast(dp->old, ap);
+  atomic_store_explicit(&dp->array, new, memory_order_release);
+
+  return new;
+}
+
+// creates an empty deque
+// Big O complexity: O(1)
+DEQUE *createDeque(void) {
+  DEQUE *dp = aligned_alloc(CACHE_LINE, sizeof(DEQUE));
+  assert(dp != NULL);
+
+  atomic_init(&dp->top, 0);
+  atomic_init(&dp->bottom, 0);
+  atomic_init(&dp->array, createArray(32));
+  dp->old = createList();
+
+  return dp;
+}
+
+// destroys deque and all arrays it has used, items themselves are not freed
+// Big O complexity: O(k), where k is the number of times the deque grew
+void destroyDeque(DEQUE *dp) {
+  assert(dp != NULL);
+
+  while (numItems(dp->old) > 0) {
+    free(removeFirst(dp->old));
+  }
+  destroyList(dp->old);
+
+  free(atomic_load(&dp->array));
+  free(dp);
+}
+
+// adds an item to the bottom of the deque, owner only
+// Big O complexity: O(1) amortized
+void pushBottom(DEQUE *dp, void *item) {
+  assert(dp != NULL && item != NULL);
+  long bottom = atomic_load_explicit(&dp->bottom, memory_order_relaxed);
+  long top = atomic_load_explicit(&dp->top, memory_order_acquire);
+  ARRAY *ap = atomic_load_explicit(&dp->array, memory_order_relaxed);
+
+  if (bottom - top > ap->length - 1) {
+    ap = growArray(dp, ap, top, bottom);
+  }
+
+  atomic_store_explicit(&ap->data[bottom & (ap->length - 1)], item,
+                        memory_order_relaxed);
+  // item must be visible before thieves can see the new bottom
+  atomic_thread_fence(memory_order_release);
+  atomic_store_explicit(&dp->bottom, bottom + 1, memory_order_relaxed);
+}
+
+// removes the item at the bottom of the deque, owner only
+// returns NULL if the deque is empty or a thief took the last item
+// Big O complexity: O(1)
+void *popBottom(DEQUE *dp) {
+  assert(dp != NULL);
+  long bottom = atomic_load_explicit(&dp->bottom, memory_order_relaxed) - 1;
+  ARRAY *ap = atomic_load_explicit(&dp->array, memory_order_relaxed);
+
+  // claim the bottom item before looking at top, thieves do the opposite
+  atomic_store_explicit(&dp->bottom, bottom, memory_order_relaxed);
+  atomic_thread_fence(memory_order_seq_cst);
+  long top = atomic_load_explicit(&dp->top, memory_order_relaxed);
+
+  // deque was already empty
+  if (top > bottom) {
+    atomic_store_explicit(&dp->bottom, bottom + 1, memory_order_relaxed);
+    return NULL;
+  }
+
+  void *item = atomic_load_explicit(&ap->data[bottom & (ap->length - 1)],
+                                    memory_order_relaxed);
+
+  // last item, race the thieves for it
+  if (top == bottom) {
+    if (!atomic_compare_exchange_strong_explicit(&dp->top, &top, top + 1,
+                                                 memory_order_seq_cst,
+                                                 memory_order_relaxed)) {
+      item = NULL;
+    }
+    atomic_store_explicit(&dp->bottom, bottom + 1, memory_order_relaxed);
+  }
+
+  return item;
+}
+
+// removes the item at the top of the deque, any thread
+// returns NULL if the deque is empty or another thread won the item
+// Big O complexity: O(1)
+void *stealTop(DEQUE *dp) {
+  assert(dp != NULL);
+  long top = atomic_load_explicit(&dp->top, memory_order_acquire);
+  atomic_thread_fence(memory_order_seq_cst);
+  long bottom = atomic_load_explicit(&dp->bottom, memory_order_acquire);
+
+  if (top >= bottom) {
+    return NULL;
+  }
+
+  ARRAY *ap = atomic_load_explicit(&dp->array, memory_order_acquire);
+  void *item = atomic_load_explicit(&ap->data[top & (ap->length - 1)],
+                                    memory_order_relaxed);
+
+  if (!atomic_compare_exchange_strong_explicit(&dp->top, &top, top + 1,
+                                               memory_order_seq_cst,
+                                               memory_order_relaxed)) {
+    return NULL;
+  }
+
+  return item;
+}
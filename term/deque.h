@@ -0,0 +1,29 @@
+/*
+ * File:	deque.h
+ *
+ * Copyright:	2023, Vladimir Ceban
+ *
+ * Description:	This file contains the public function and type
+ *		declarations for a Chase-Lev work-stealing deque of generic
+ *		pointer types.  One owner thread adds and removes items at
+ *		the bottom of the deque, exactly like a stack, while any
+ *		number of other threads may steal items from the top.  The
+ *		deque grows as needed and does not store null pointers.
+ */
+
+# ifndef DEQUE_H
+# define DEQUE_H
+
+typedef struct deque DEQUE;
+
+extern DEQUE *createDeque(void);
+
+extern void destroyDeque(DEQUE *dp);
+
+extern void pushBottom(DEQUE *dp, void *item);
+
+extern void *popBottom(DEQUE *dp);
+
+extern void *stealTop(DEQUE *dp);
+
+# endif /* DEQUE_H */
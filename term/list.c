@@ -3,6 +3,11 @@
 #include <malloc.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+
+// shortest and longest arrays a node will get
+#define MIN_LENGTH 10
+#define MAX_LENGTH (1 << 20)
 
 // defines node
 typedef struct node {
@@ -16,12 +21,22 @@ typedef struct node {
 
 // defines list
 typedef struct list {
-  int count;  // num of items in list (summ of all node->counts)
-  NODE *head; // points to sentinel head node
+  int count;     // num of items in list (summ of all node->counts)
+  NODE *head;    // points to sentinel head node
+  size_t bytes;  // memory held by list, nodes and arrays
+  size_t budget; // memory the list tries to stay under, 0 if none
 } LIST;
 
-// defines local function to create nodes
-static NODE *createNode(NODE *);
+// defines local functions to create and free nodes
+static NODE *createNode(LIST *);
+static void freeNode(LIST *, NODE *);
+static void checkBudget(LIST *);
+
+// returns the smallest of three ints, used to size runs in bulk functions
+static int min3(int a, int b, int c) {
+  int m = a < b ? a : b;
+  return m < c ? m : c;
+}
 
 // creates list with sentinel head node
 // head holds length of the array in next created node
@@ -37,8 +52,10 @@ LIST *createList(void) {
   head->next = head->prev = lp->head;
   head->data = NULL;
   // this makes head always full, important for insertion functions
-  head->count = head->start = head->length = 10;
+  head->count = head->start = head->length = MIN_LENGTH;
   lp->count = 0;
+  lp->bytes = sizeof(LIST) + sizeof(NODE);
+  lp->budget = 0;
 
   return lp;
 }
@@ -66,24 +83,71 @@ int numItems(LIST *lp) {
   return lp->count;
 }
 
+// memory used by a node whose array has given length
+#define NODE_BYTES(length) (sizeof(NODE) + sizeof(void *) * (length))
+
+// sets the length of the array in next created node
+// head's count is changed with it so that head stays full
+// Big O complexity: O(1)
+static void setNextLength(LIST *lp, int length) {
+  if (length < MIN_LENGTH) {
+    length = MIN_LENGTH;
+  } else if (length > MAX_LENGTH) {
+    length = MAX_LENGTH;
+  }
+  lp->head->length = lp->head->count = length;
+}
+
 // creates a new node based on heads length and returns a pointer to it
-// is used in functions that create nodes
+// is used in functions that create nodes, the caller links it in
+// with a budget, no single node may take more than a quarter of it, so that
+// memory comes back in small enough pieces as the list drains
 // Big O complexity: O(1)
-static NODE *createNode(NODE *head) {
+static NODE *createNode(LIST *lp) {
   NODE *new = malloc(sizeof(NODE));
   assert(new != NULL);
   // create empty node
   new->count = new->start = 0;
-  new->length = head->length;
+  new->length = lp->head->length;
+  while (lp->budget > 0 && new->length > MIN_LENGTH &&
+         NODE_BYTES(new->length) > lp->budget / 4) {
+    new->length /= 2;
+  }
   new->data = malloc(sizeof(void *) * new->length);
   assert(new->data != NULL);
+  lp->bytes += NODE_BYTES(new->length);
 
   // double length for next node
-  head->length *= 2;
+  setNextLength(lp, new->length * 2);
 
   return (new);
 }
 
+// unlinks a node from the list and frees it
+// the node's length goes back to head, so a list that keeps creating and
+// freeing a node at one end reuses the same length instead of doubling it
+// Big O complexity: O(1)
+static void freeNode(LIST *lp, NODE *node) {
+  node->prev->next = node->next;
+  node->next->prev = node->prev;
+  lp->bytes -= NODE_BYTES(node->length);
+  setNextLength(lp, node->length);
+  free(node->data);
+  free(node);
+}
+
+// compacts the list when it holds more memory than its budget allows, but
+// only once the compacted list would need at most half of the budget so that
+// a list hovering around the budget is not compacted on every removal
+// Big O complexity: O(1), or O(n) when it compacts
+static void checkBudget(LIST *lp) {
+  int length = lp->count > MIN_LENGTH ? lp->count : MIN_LENGTH;
+  if (lp->budget > 0 && lp->bytes > lp->budget &&
+      sizeof(LIST) + sizeof(NODE) + NODE_BYTES(length) <= lp->budget / 2) {
+    shrinkToFit(lp);
+  }
+}
+
 // adds an item in the beginning of the list
 // BigO complexity: O(1)
 void addFirst(LIST *lp, void *item) {
@@ -97,7 +161,7 @@ void addFirst(LIST *lp, void *item) {
   // if it's the very first node in the list or if the first node is full
   // head is always full, so very first node will condition triggers
   if (first->count == first->length) {
-    NODE *new = createNode(head);
+    NODE *new = createNode(lp);
 
     // shift pointers around
     new->next = first;
@@ -127,7 +191,7 @@ void addLast(LIST *lp, void *item) {
   NODE *last = head->prev;
   // if it's the very first node in the list or if the last node is full
   if (last->count == last->length) {
-    NODE *new = createNode(head);
+    NODE *new = createNode(lp);
 
     // shift pounters around
     new->prev = last;
@@ -154,10 +218,7 @@ void *removeFirst(LIST *lp) {
   NODE *first = head->next;
   // no need to keep the empty node in memory
   if (first->count == 0) {
-    head->next = first->next;
-    first->next->prev = head;
-    free(first->data);
-    free(first);
+    freeNode(lp, first);
     first = head->next;
   }
 
@@ -165,6 +226,7 @@ void *removeFirst(LIST *lp) {
   first->start = (first->start + 1) % first->length;
   first->count--;
   lp->count--;
+  checkBudget(lp);
 
   return data;
 }
@@ -178,16 +240,14 @@ void *removeLast(LIST *lp) {
   NODE *last = head->prev;
   // no need to keep the empty node in memory
   if (last->count == 0) {
-    head->prev = last->prev;
-    last->prev->next = head;
-    free(last->data);
-    free(last);
+    freeNode(lp, last);
     last = head->prev;
   }
 
   last->count--;
   void *data = last->data[(last->start + last->count) % last->length];
   lp->count--;
+  checkBudget(lp);
 
   return data;
 }
@@ -198,6 +258,10 @@ void *getFirst(LIST *lp) {
   assert(lp != NULL && lp->count > 0);
   // pointers for clean code
   NODE *first = lp->head->next;
+  // removeFirst leaves an emptied node in place, the item is in the next one
+  if (first->count == 0) {
+    first = first->next;
+  }
   void *data = first->data[first->start];
 
   return data;
@@ -209,6 +273,10 @@ void *getLast(LIST *lp) {
   assert(lp != NULL && lp->count > 0);
   // pointers for clean code
   NODE *last = lp->head->prev;
+  // removeLast leaves an emptied node in place, the item is in the previous one
+  if (last->count == 0) {
+    last = last->prev;
+  }
   void *data = last->data[(last->start + last->count - 1) % last->length];
 
   return data;
@@ -241,3 +309,188 @@ void setItem(LIST *lp, int index, void *item) {
   }
   this->data[(this->start + index) % this->length] = item;
 }
+
+// adds n items to the beginning of the list, so that items[0] becomes the
+// first item and the order of the array is kept. items must not be NULL
+// each run between the start of a node's array and a node boundary is moved
+// with a single memcpy instead of one addFirst per item
+// BigO complexity: O(n)
+void addFirstN(LIST *lp, void **items, int n) {
+  assert(lp != NULL && n >= 0 && (n == 0 || items != NULL));
+  NODE *head = lp->head;
+
+  while (n > 0) {
+    NODE *first = head->next;
+    // same as addFirst, a full node (or the head) needs a new node in front
+    if (first->count == first->length) {
+      NODE *new = createNode(lp);
+      new->next = first;
+      new->prev = head;
+      head->next = first->prev = new;
+      first = new;
+    }
+
+    // free slots right before start, wrapping to the end of the array when
+    // start is 0. fill them with the last items that are still left
+    int run = min3(n, first->length - first->count,
+                   first->start > 0 ? first->start : first->length);
+    first->start = (first->start - run + first->length) % first->length;
+    memcpy(&first->data[first->start], items + n - run, sizeof(void *) * run);
+
+    first->count += run;
+    lp->count += run;
+    n -= run;
+  }
+}
+
+// adds n items to the end of the list, so that items[n - 1] becomes the last
+// item. items must not be NULL
+// BigO complexity: O(n)
+void addLastN(LIST *lp, void **items, int n) {
+  assert(lp != NULL && n >= 0 && (n == 0 || items != NULL));
+  NODE *head = lp->head;
+
+  while (n > 0) {
+    NODE *last = head->prev;
+    // same as addLast, a full node (or the head) needs a new node after it
+    if (last->count == last->length) {
+      NODE *new = createNode(lp);
+      new->prev = last;
+      new->next = head;
+      head->prev = last->next = new;
+      last = new;
+    }
+
+    // free slots right after the last item, up to the end of the array
+    int end = (last->start + last->count) % last->length;
+    int run = min3(n, last->length - last->count, last->length - end);
+    memcpy(&last->data[end], items, sizeof(void *) * run);
+
+    last->count += run;
+    lp->count += run;
+    items += run;
+    n -= run;
+  }
+}
+
+// removes the first n items of the list and stores them in items in list
+// order, so items[0] is the item that was first
+// BigO complexity: O(n)
+void removeFirstN(LIST *lp, void **items, int n) {
+  assert(lp != NULL && n >= 0 && n <= lp->count && (n == 0 || items != NULL));
+  NODE *head = lp->head;
+
+  while (n > 0) {
+    NODE *first = head->next;
+    // same as removeFirst, drop the node emptied by an earlier call
+    if (first->count == 0) {
+      freeNode(lp, first);
+      first = head->next;
+    }
+
+    // items from start up to the end of the array or of the node
+    int run = min3(n, first->count, first->length - first->start);
+    memcpy(items, &first->data[first->start], sizeof(void *) * run);
+    first->start = (first->start + run) % first->length;
+
+    first->count -= run;
+    lp->count -= run;
+    items += run;
+    n -= run;
+  }
+
+  checkBudget(lp);
+}
+
+// removes the last n items of the list and stores them in items in list
+// order, so items[n - 1] is the item that was last
+// BigO complexity: O(n)
+void removeLastN(LIST *lp, void **items, int n) {
+  assert(lp != NULL && n >= 0 && n <= lp->count && (n == 0 || items != NULL));
+  NODE *head = lp->head;
+
+  while (n > 0) {
+    NODE *last = head->prev;
+    // same as removeLast, drop the node emptied by an earlier call
+    if (last->count == 0) {
+      freeNode(lp, last);
+      last = head->prev;
+    }
+
+    // items before the end of the node, down to the start of the array
+    int end = (last->start + last->count) % last->length;
+    int run = min3(n, last->count, end > 0 ? end : last->length);
+    int from = (end - run + last->length) % last->length;
+    memcpy(items + n - run, &last->data[from], sizeof(void *) * run);
+
+    last->count -= run;
+    lp->count -= run;
+    n -= run;
+  }
+
+  checkBudget(lp);
+}
+
+// sets how much memory the list should hold on to, in bytes, 0 for no limit
+// the list may go over its budget while it holds many items, but new nodes
+// stay small relative to the budget and the list compacts itself once enough
+// items are removed
+// BigO complexity: O(1), or O(n) if the list compacts right away
+void setBudget(LIST *lp, size_t bytes) {
+  assert(lp != NULL);
+  lp->budget = bytes;
+  checkBudget(lp);
+}
+
+// returns the number of bytes the list holds, including its nodes
+// BigO complexity: O(1)
+size_t memoryUsage(LIST *lp) {
+  assert(lp != NULL);
+  return lp->bytes;
+}
+
+// moves all items into one node just large enough to hold them and frees
+// every other node, the next node created will be the same length again
+// an empty list gives back all of its nodes
+// BigO complexity: O(n)
+void shrinkToFit(LIST *lp) {
+  assert(lp != NULL);
+  NODE *head = lp->head;
+  NODE *new = NULL;
+
+  if (lp->count > 0) {
+    // copy the items out before any node is freed
+    new = malloc(sizeof(NODE));
+    assert(new != NULL);
+    new->length = lp->count > MIN_LENGTH ? lp->count : MIN_LENGTH;
+    new->data = malloc(sizeof(void *) * new->length);
+    assert(new->data != NULL);
+    new->start = new->count = 0;
+
+    NODE *this;
+    for (this = head->next; this != head; this = this->next) {
+      // a node's items are at most two runs, before and after the wrap
+      int run = this->count < this->length - this->start
+                    ? this->count
+                    : this->length - this->start;
+      memcpy(&new->data[new->count], &this->data[this->start],
+             sizeof(void *) * run);
+      memcpy(&new->data[new->count + run], this->data,
+             sizeof(void *) * (this->count - run));
+      new->count += this->count;
+    }
+  }
+
+  while (head->next != head) {
+    freeNode(lp, head->next);
+  }
+
+  if (new != NULL) {
+    new->next = new->prev = head;
+    head->next = head->prev = new;
+    lp->bytes += NODE_BYTES(new->length);
+    setNextLength(lp, new->length);
+  } else {
+    setNextLength(lp, MIN_LENGTH);
+  }
+}
@@ -7,12 +7,18 @@
  *		declarations for a list abstract data type for generic
  *		pointer types.  The list supports deque operations, in
  *		which items can be easily added to or removed from the
- *		front or rear of the list, as well as indexing.
+ *		front or rear of the list, as well as indexing.  Whole
+ *		arrays of items can also be added to or removed from
+ *		either end in one call.  The memory held by the list
+ *		can be queried, capped by a budget, and given back by
+ *		compacting the list.
  */
 
 # ifndef LIST_H
 # define LIST_H
 
+# include <stddef.h>
+
 typedef struct list LIST;
 
 extern LIST *createList(void);
@@ -37,4 +43,18 @@ extern void *getItem(LIST *lp, int index);
 
 extern void setItem(LIST *lp, int index, void *item);
 
+extern void addFirstN(LIST *lp, void **items, int n);
+
+extern void addLastN(LIST *lp, void **items, int n);
+
+extern void removeFirstN(LIST *lp, void **items, int n);
+
+extern void removeLastN(LIST *lp, void **items, int n);
+
+extern void setBudget(LIST *lp, size_t bytes);
+
+extern size_t memoryUsage(LIST *lp);
+
+extern void shrinkToFit(LIST *lp);
+
 # endif /* LIST_H */
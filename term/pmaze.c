@@ -0,0 +1,346 @@
+/*
+ * File:	pmaze.c
+ *
+ * Copyright:	2023, Vladimir Ceban
+ *
+ * Description:	Generate a large maze off screen and solve it twice: once
+ *		with the same depth-first search that maze.c uses, with a
+ *		list as the stack, and once in parallel with the
+ *		work-stealing pool.  In the parallel search a worker keeps
+ *		walking down one corridor and spawns a task for every other
+ *		corridor it passes, which idle workers then steal.  The
+ *		time taken by each search and the length of the path found
+ *		are printed.  Since the maze is perfect, both searches must
+ *		find the same path.
+ *
+ *		usage: pmaze [-j workers] [width [height]]
+ */
+
+# include <time.h>		/* for time(), used to seed the rng */
+# include <stdio.h>
+# include <stdint.h>
+# include <stdlib.h>
+# include <assert.h>
+# include <unistd.h>		/* for getopt() and sysconf() */
+# include <stdbool.h>
+# include <stdatomic.h>
+# include "list.h"
+# include "pool.h"
+
+/* Cells are stored in the list and the pool as their index plus one,
+   since neither allows null pointers. */
+
+# define TASK(c)	((void *) (intptr_t) ((c) + 1))
+# define INDEX(p)	((int) ((intptr_t) (p) - 1))
+
+typedef struct cell CELL;
+
+int width;
+int height;
+int goal;
+CELL *maze;
+int *from;
+atomic_char *visited;
+
+struct cell {
+    bool bottom, right;
+};
+
+
+/*
+ * Function:	elapsed
+ *
+ * Description:	Return the number of seconds since the given time.
+ */
+
+static double elapsed(struct timespec *start)
+{
+    struct timespec now;
+
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (now.tv_sec - start->tv_sec) + (now.tv_nsec - start->tv_nsec) / 1e9;
+}
+
+
+/*
+ * Function:	buildMaze
+ *
+ * Description:	Build the maze using depth-first search exactly like
+ *		maze.c, but with an explicit stack instead of recursion so
+ *		that very large mazes do not overflow the call stack.  The
+ *		front of the list is the top of the stack.
+ */
+
+static void buildMaze(void)
+{
+    int c, x, y, numOffsets, offset, offsets[4];
+    LIST *list;
+
+
+    for (c = 0; c < width * height; c ++) {
+	maze[c].bottom = true;
+	maze[c].right = true;
+	visited[c] = false;
+    }
+
+    list = createList();
+    addFirst(list, TASK(0));
+    visited[0] = true;
+
+    while (numItems(list) > 0) {
+	c = INDEX(getFirst(list));
+	x = c % width;
+	y = c / width;
+	numOffsets = 0;
+
+	if (y > 0 && !visited[c - width])
+	    offsets[numOffsets ++] = -width;
+
+	if (y < height - 1 && !visited[c + width])
+	    offsets[numOffsets ++] = width;
+
+	if (x > 0 && !visited[c - 1])
+	    offsets[numOffsets ++] = -1;
+
+	if (x < width - 1 && !visited[c + 1])
+	    offsets[numOffsets ++] = 1;
+
+	if (numOffsets == 0) {
+	    removeFirst(list);
+	    continue;
+	}
+
+	offset = offsets[rand() % numOffsets];
+
+	if (offset == -width)
+	    maze[c - width].bottom = false;
+	else if (offset == width)
+	    maze[c].bottom = false;
+	else if (offset == -1)
+	    maze[c - 1].right = false;
+	else
+	    maze[c].right = false;
+
+	visited[c + offset] = true;
+	addFirst(list, TASK(c + offset));
+    }
+
+    destroyList(list);
+}
+
+
+/*
+ * Function:	neighbors
+ *
+ * Description:	Store the cells reachable in one step from cell C that have
+ *		not been visited yet in N, and return how many there are.
+ *		We try right, then down, then left, then up, like maze.c.
+ */
+
+static int neighbors(int c, int n[4])
+{
+    int x, y, count;
+
+
+    x = c % width;
+    y = c / width;
+    count = 0;
+
+    if (x < width - 1 && !maze[c].right && !visited[c + 1])
+	n[count ++] = c + 1;
+
+    if (y < height - 1 && !maze[c].bottom && !visited[c + width])
+	n[count ++] = c + width;
+
+    if (x > 0 && !maze[c - 1].right && !visited[c - 1])
+	n[count ++] = c - 1;
+
+    if (y > 0 && !maze[c - width].bottom && !visited[c - width])
+	n[count ++] = c - width;
+
+    return count;
+}
+
+
+/*
+ * Function:	solveSerial
+ *
+ * Description:	Solve the maze using a depth-first search with the rear of
+ *		the list as the top of the stack, as in maze.c.
+ */
+
+static void solveSerial(void)
+{
+    int c, i, count, n[4];
+    LIST *list;
+
+
+    list = createList();
+    addLast(list, TASK(0));
+
+    while (numItems(list) > 0) {
+	c = INDEX(removeLast(list));
+
+	if (visited[c])
+	    continue;
+
+	visited[c] = true;
+
+	if (c == goal)
+	    break;
+
+	count = neighbors(c, n);
+
+	for (i = 0; i < count; i ++) {
+	    from[n[i]] = c;
+	    addLast(list, TASK(n[i]));
+	}
+    }
+
+    destroyList(list);
+}
+
+
+/*
+ * Function:	explore
+ *
+ * Description:	Task function for the parallel search.  Walk from the given
+ *		cell, always taking the first open corridor and spawning a
+ *		task for the others.  The exchange on the visited flag
+ *		makes sure each cell is explored by only one worker.  Since
+ *		the maze is a tree, each cell also has only one possible
+ *		predecessor, so FROM is never written twice.
+ */
+
+static void explore(POOL *pp, int worker, void *task)
+{
+    int c, i, count, n[4];
+
+
+    c = INDEX(task);
+
+    while (!atomic_exchange(&visited[c], true)) {
+	if (c == goal) {
+	    stopPool(pp);
+	    return;
+	}
+
+	count = neighbors(c, n);
+
+	if (count == 0)
+	    return;
+
+	for (i = 0; i < count; i ++)
+	    from[n[i]] = c;
+
+	for (i = 1; i < count; i ++)
+	    spawnTask(pp, worker, TASK(n[i]));
+
+	c = n[0];
+    }
+}
+
+
+/*
+ * Function:	pathLength
+ *
+ * Description:	Return the number of steps from the start to the goal by
+ *		following the predecessors back from the goal.
+ */
+
+static int pathLength(void)
+{
+    int c, length;
+
+
+    length = 0;
+
+    for (c = goal; c != 0; c = from[c])
+	length ++;
+
+    return length;
+}
+
+
+/*
+ * Function:	main
+ *
+ * Description:	Driver function for the pmaze application.
+ */
+
+int main(int argc, char *argv[])
+{
+    int c, opt, workers, serial, parallel;
+    struct timespec start;
+    double secs;
+    POOL *pp;
+
+
+    workers = sysconf(_SC_NPROCESSORS_ONLN);
+
+    while ((opt = getopt(argc, argv, "j:")) != -1) {
+	if (opt == 'j' && atoi(optarg) > 0)
+	    workers = atoi(optarg);
+	else {
+	    fprintf(stderr, "usage: %s [-j workers] [width [height]]\n",
+		    argv[0]);
+	    exit(EXIT_FAILURE);
+	}
+    }
+
+    width = optind < argc ? atoi(argv[optind]) : 2000;
+    height = optind + 1 < argc ? atoi(argv[optind + 1]) : width;
+
+    if (width < 2 || height < 2) {
+	fprintf(stderr, "%s: maze must be at least 2 by 2\n", argv[0]);
+	exit(EXIT_FAILURE);
+    }
+
+    goal = width * height - 1;
+    maze = malloc(sizeof(CELL) * width * height);
+    from = malloc(sizeof(int) * width * height);
+    visited = malloc(sizeof(atomic_char) * width * height);
+    assert(maze != NULL && from != NULL && visited != NULL);
+
+    srand(time(NULL));
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    buildMaze();
+    printf("build %dx%d: %.3fs\n", width, height, elapsed(&start));
+
+
+    /* Solve it with one thread and the list. */
+
+    for (c = 0; c < width * height; c ++)
+	visited[c] = false;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    solveSerial();
+    secs = elapsed(&start);
+    serial = pathLength();
+    printf("serial: %.3fs, path %d\n", secs, serial);
+
+
+    /* Solve it again with the pool. */
+
+    for (c = 0; c < width * height; c ++)
+	visited[c] = false;
+
+    pp = createPool(workers, explore);
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    runPool(pp, TASK(0));
+    secs = elapsed(&start);
+    destroyPool(pp);
+    parallel = pathLength();
+    printf("%d workers: %.3fs, path %d\n", workers, secs, parallel);
+
+    if (serial != parallel) {
+	fprintf(stderr, "%s: searches disagree\n", argv[0]);
+	exit(EXIT_FAILURE);
+    }
+
+    free(maze);
+    free(from);
+    free(visited);
+    exit(EXIT_SUCCESS);
+}
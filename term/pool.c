@@ -0,0 +1,160 @@
+/*
+ * File: pool.c
+ *
+ * Copyright:	2023, Vladimir Ceban
+ *
+ * Description: This file contains functions defined in pool.h. Every worker
+ * owns one deque from deque.c. A worker treats its own deque as a stack, so
+ * it keeps working depth first on the tasks it just spawned, and steals from
+ * the other end of a random victim's deque when it has nothing left. Stolen
+ * tasks are the oldest ones, which in a depth first search are the ones
+ * closest to the root and so usually carry the most work.
+ *
+ */
+
+#include "pool.h"
+#include "deque.h"
+#include <assert.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdlib.h>
+
+// defines pool
+typedef struct pool {
+  int nworkers;
+  DEQUE **deques;                            // one deque per worker
+  void (*run)(POOL *pp, int worker, void *); // runs one task
+  atomic_long pending;                       // tasks spawned but not done
+  atomic_bool stop;                          // set by stopPool
+} POOL;
+
+// defines what each worker thread is given
+typedef struct worker {
+  POOL *pp;
+  int id;
+  unsigned seed; // for picking victims
+} WORKER;
+
+// runs tasks until all are done or the pool is stopped
+// Big O complexity: O(t), where t is the number of tasks run by this worker
+static void *work(void *arg) {
+  WORKER *wp = arg;
+  POOL *pp = wp->pp;
+  DEQUE *own = pp->deques[wp->id];
+
+  while (!atomic_load(&pp->stop) && atomic_load(&pp->pending) > 0) {
+    void *task = popBottom(own);
+
+    // nothing of our own, try someone else's
+    if (task == NULL && pp->nworkers > 1) {
+      int victim = rand_r(&wp->seed) % pp->nworkers;
+      if (victim != wp->id) {
+        task = stealTop(pp->deques[victim]);
+      }
+    }
+
+    if (task == NULL) {
+      sched_yield();
+      continue;
+    }
+
+    pp->run(pp, wp->id, task);
+    // tasks spawned by run were counted before this one is uncounted
+    atomic_fetch_sub(&pp->pending, 1);
+  }
+
+  return NULL;
+}
+
+// creates pool with given number of workers and task function
+// Big O complexity: O(w), where w is the number of workers
+POOL *createPool(int nworkers, void (*run)(POOL *pp, int worker, void *task)) {
+  assert(nworkers > 0 && run != NULL);
+
+  POOL *pp = malloc(sizeof(POOL));
+  assert(pp != NULL);
+
+  pp->nworkers = nworkers;
+  pp->run = run;
+  pp->deques = malloc(sizeof(DEQUE *) * nworkers);
+  assert(pp->deques != NULL);
+
+  int i;
+  for (i = 0; i < nworkers; i++) {
+    pp->deques[i] = createDeque();
+  }
+
+  atomic_init(&pp->pending, 0);
+  atomic_init(&pp->stop, false);
+
+  return pp;
+}
+
+// destroys pool and its deques
+// Big O complexity: O(w), where w is the number of workers
+void destroyPool(POOL *pp) {
+  assert(pp != NULL);
+
+  int i;
+  for (i = 0; i < pp->nworkers; i++) {
+    destroyDeque(pp->deques[i]);
+  }
+
+  free(pp->deques);
+  free(pp);
+}
+
+// adds a task to the deque of the given worker
+// must be called from within run by the worker that is running it
+// Big O complexity: O(1) amortized
+void spawnTask(POOL *pp, int worker, void *task) {
+  assert(pp != NULL && worker >= 0 && worker < pp->nworkers);
+  atomic_fetch_add(&pp->pending, 1);
+  pushBottom(pp->deques[worker], task);
+}
+
+// runs root and every task it spawns, returns when all of them are done or
+// stopPool was called. tasks left over after a stop are dropped
+// Big O complexity: O(t / w), where t is the number of tasks
+void runPool(POOL *pp, void *root) {
+  assert(pp != NULL && root != NULL);
+
+  pthread_t *threads = malloc(sizeof(pthread_t) * pp->nworkers);
+  WORKER *workers = malloc(sizeof(WORKER) * pp->nworkers);
+  assert(threads != NULL && workers != NULL);
+
+  atomic_store(&pp->stop, false);
+  atomic_store(&pp->pending, 1);
+  // safe before the threads exist, creating them orders this push
+  pushBottom(pp->deques[0], root);
+
+  int i;
+  for (i = 0; i < pp->nworkers; i++) {
+    workers[i].pp = pp;
+    workers[i].id = i;
+    workers[i].seed = i + 1;
+    pthread_create(&threads[i], NULL, work, &workers[i]);
+  }
+
+  for (i = 0; i < pp->nworkers; i++) {
+    pthread_join(threads[i], NULL);
+  }
+
+  // every worker has exited, so this thread may act as the owner
+  for (i = 0; i < pp->nworkers; i++) {
+    while (popBottom(pp->deques[i]) != NULL)
+      ;
+  }
+
+  free(threads);
+  free(workers);
+}
+
+// asks the workers to finish the task they are running and return
+// Big O complexity: O(1)
+void stopPool(POOL *pp) {
+  assert(pp != NULL);
+  atomic_store(&pp->stop, true);
+}
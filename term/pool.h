@@ -0,0 +1,31 @@
+/*
+ * File:	pool.h
+ *
+ * Copyright:	2023, Vladimir Ceban
+ *
+ * Description:	This file contains the public function and type
+ *		declarations for a work-stealing task pool.  Each worker
+ *		thread keeps its own deque of tasks, runs the newest task
+ *		it has, and steals the oldest task of another worker when
+ *		it runs out.  A task is any non-null pointer; the function
+ *		given to createPool is called to run it and may spawn more
+ *		tasks on the worker that runs it.
+ */
+
+# ifndef POOL_H
+# define POOL_H
+
+typedef struct pool POOL;
+
+extern POOL *createPool(int nworkers,
+	void (*run)(POOL *pp, int worker, void *task));
+
+extern void destroyPool(POOL *pp);
+
+extern void spawnTask(POOL *pp, int worker, void *task);
+
+extern void runPool(POOL *pp, void *root);
+
+extern void stopPool(POOL *pp);
+
+# endif /* POOL_H */
@@ -0,0 +1,261 @@
+/*
+ * File:	qbench.c
+ *
+ * Copyright:	2023, Vladimir Ceban
+ *
+ * Description:	Measure the throughput of the concurrent queues in queue.c
+ *		against the list from list.c protected by a single mutex.
+ *		For each thread count, the same number of producer and
+ *		consumer threads pass a fixed number of items through the
+ *		queue and the number of items per second is printed.  The
+ *		consumers add up every item they see so that a lost or
+ *		duplicated item is detected.
+ *
+ *		usage: qbench [items]
+ */
+
+# include <time.h>
+# include <stdio.h>
+# include <sched.h>		/* for sched_yield() */
+# include <stdint.h>
+# include <stdlib.h>
+# include <assert.h>
+# include <pthread.h>
+# include <stdatomic.h>
+# include "list.h"
+# include "queue.h"
+
+# define LENGTH 1024		/* capacity of the bounded queues */
+# define MAX_THREADS 8		/* largest number of producers */
+
+typedef struct locked LOCKED;
+typedef struct bench BENCH;
+
+typedef bool (*ENQUEUE)(void *queue, void *item);
+typedef void *(*DEQUEUE)(void *queue);
+
+struct locked {
+    LIST *list;
+    pthread_mutex_t lock;
+};
+
+struct bench {
+    void *queue;
+    ENQUEUE enqueue;
+    DEQUEUE dequeue;
+    long items;				/* items per thread */
+    long first;				/* value of first item */
+    pthread_barrier_t *start;
+    atomic_long *sum;
+};
+
+
+/*
+ * Functions:	spscEnqueue, spscDequeue, mpmcEnqueue, mpmcDequeue
+ *
+ * Description:	Call the queue functions through the ENQUEUE and DEQUEUE
+ *		types, which take the queue as a generic pointer.
+ */
+
+static bool spscEnqueue(void *queue, void *item)
+{
+    return enqueueSPSC(queue, item);
+}
+
+static void *spscDequeue(void *queue)
+{
+    return dequeueSPSC(queue);
+}
+
+static bool mpmcEnqueue(void *queue, void *item)
+{
+    return enqueueMPMC(queue, item);
+}
+
+static void *mpmcDequeue(void *queue)
+{
+    return dequeueMPMC(queue);
+}
+
+
+/*
+ * Functions:	enqueueLocked, dequeueLocked
+ *
+ * Description:	Wrap the list in a mutex so that it can be compared with the
+ *		lock-free queues.  The list is unbounded, so it is never
+ *		full.
+ */
+
+static bool enqueueLocked(void *queue, void *item)
+{
+    LOCKED *lp = queue;
+
+
+    pthread_mutex_lock(&lp->lock);
+    addLast(lp->list, item);
+    pthread_mutex_unlock(&lp->lock);
+    return true;
+}
+
+static void *dequeueLocked(void *queue)
+{
+    LOCKED *lp = queue;
+    void *item = NULL;
+
+
+    pthread_mutex_lock(&lp->lock);
+
+    if (numItems(lp->list) > 0)
+	item = removeFirst(lp->list);
+
+    pthread_mutex_unlock(&lp->lock);
+    return item;
+}
+
+
+/*
+ * Functions:	producer, consumer
+ *
+ * Description:	Thread bodies.  A thread that finds the queue full or empty
+ *		yields the processor so that the benchmark still makes
+ *		progress when there are more threads than cores.
+ */
+
+static void *producer(void *arg)
+{
+    BENCH *bp = arg;
+    long i;
+
+
+    pthread_barrier_wait(bp->start);
+
+    for (i = 0; i < bp->items; i ++)
+	while (!bp->enqueue(bp->queue, (void *) (intptr_t) (bp->first + i)))
+	    sched_yield();
+
+    return NULL;
+}
+
+static void *consumer(void *arg)
+{
+    BENCH *bp = arg;
+    long i, sum;
+    void *item;
+
+
+    sum = 0;
+    pthread_barrier_wait(bp->start);
+
+    for (i = 0; i < bp->items; i ++) {
+	while ((item = bp->dequeue(bp->queue)) == NULL)
+	    sched_yield();
+
+	sum += (intptr_t) item;
+    }
+
+    atomic_fetch_add(bp->sum, sum);
+    return NULL;
+}
+
+
+/*
+ * Function:	run
+ *
+ * Description:	Run NTHREADS producers and NTHREADS consumers over the given
+ *		queue, check the sum of the items, and print the rate.
+ */
+
+static void run(char *name, int nthreads, long total, void *queue,
+		ENQUEUE enqueue, DEQUEUE dequeue)
+{
+    int i;
+    long per;
+    double secs;
+    atomic_long sum;
+    struct timespec t0, t1;
+    pthread_barrier_t start;
+    pthread_t threads[2 * MAX_THREADS];
+    BENCH bench[2 * MAX_THREADS];
+
+
+    per = total / nthreads;
+    atomic_init(&sum, 0);
+    pthread_barrier_init(&start, NULL, 2 * nthreads + 1);
+
+    for (i = 0; i < 2 * nthreads; i ++) {
+	bench[i].queue = queue;
+	bench[i].enqueue = enqueue;
+	bench[i].dequeue = dequeue;
+	bench[i].items = per;
+	bench[i].first = (i / 2) * per + 1;
+	bench[i].start = &start;
+	bench[i].sum = &sum;
+	pthread_create(&threads[i], NULL, i % 2 ? consumer : producer,
+		&bench[i]);
+    }
+
+    pthread_barrier_wait(&start);
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+
+    for (i = 0; i < 2 * nthreads; i ++)
+	pthread_join(threads[i], NULL);
+
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    pthread_barrier_destroy(&start);
+
+    total = per * nthreads;
+
+    if (atomic_load(&sum) != total * (total + 1) / 2) {
+	fprintf(stderr, "%s: items lost or duplicated\n", name);
+	exit(EXIT_FAILURE);
+    }
+
+    secs = (t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) / 1e9;
+    printf("%-6s %4d %4d %12.0f\n", name, nthreads, nthreads, total / secs);
+}
+
+
+/*
+ * Function:	main
+ *
+ * Description:	Driver function for the qbench application.
+ */
+
+int main(int argc, char *argv[])
+{
+    int n;
+    long total;
+    SPSC *spsc;
+    MPMC *mpmc;
+    LOCKED locked;
+
+
+    total = argc > 1 ? atol(argv[1]) : 1L << 22;
+
+    if (total <= 0) {
+	fprintf(stderr, "usage: %s [items]\n", argv[0]);
+	exit(EXIT_FAILURE);
+    }
+
+    printf("%-6s %4s %4s %12s\n", "queue", "prod", "cons", "items/sec");
+
+    spsc = createSPSC(LENGTH);
+    run("spsc", 1, total, spsc, spscEnqueue, spscDequeue);
+    destroySPSC(spsc);
+
+    for (n = 1; n <= MAX_THREADS; n *= 2) {
+	mpmc = createMPMC(LENGTH);
+	run("mpmc", n, total, mpmc, mpmcEnqueue, mpmcDequeue);
+	destroyMPMC(mpmc);
+    }
+
+    for (n = 1; n <= MAX_THREADS; n *= 2) {
+	locked.list = createList();
+	pthread_mutex_init(&locked.lock, NULL);
+	run("mutex", n, total, &locked, enqueueLocked, dequeueLocked);
+	pthread_mutex_destroy(&locked.lock);
+	destroyList(locked.list);
+    }
+
+    exit(EXIT_SUCCESS);
+}
@@ -0,0 +1,238 @@
+/*
+ * File: queue.c
+ *
+ * Copyright:	2023, Vladimir Ceban
+ *
+ * Description: This file contains functions defined in queue.h. Both queues
+ * use the same circular array idea as the nodes in list.c, but the array has a
+ * fixed power of two length so that positions can grow forever and be masked
+ * into the array instead of being wrapped with a modulo.
+ *
+ * The counters written by producers and the counters written by consumers are
+ * kept on separate cache lines, otherwise every enqueue would invalidate the
+ * line the consumers are reading from and the other way around (false
+ * sharing).
+ *
+ */
+
+#include "queue.h"
+#include "cache.h"
+#include <assert.h>
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+// defines single producer, single consumer queue
+typedef struct spsc {
+  // written by consumer only
+  _Alignas(CACHE_LINE) atomic_size_t head;
+  size_t cachedTail; // consumer's last look at tail
+  // written by producer only
+  _Alignas(CACHE_LINE) atomic_size_t tail;
+  size_t cachedHead; // producer's last look at head
+  // never written after creation
+  _Alignas(CACHE_LINE) void **data;
+  size_t mask; // length of array - 1
+} SPSC;
+
+// defines one slot of the multi producer, multi consumer queue
+typedef struct slot {
+  atomic_size_t seq; // tells whose turn it is to use this slot
+  void *data;
+} SLOT;
+
+// defines multi producer, multi consumer queue
+typedef struct mpmc {
+  // never written after creation
+  _Alignas(CACHE_LINE) SLOT *slots;
+  size_t mask; // length of array - 1
+  // position of next enqueue, shared by producers
+  _Alignas(CACHE_LINE) atomic_size_t tail;
+  // position of next dequeue, shared by consumers
+  _Alignas(CACHE_LINE) atomic_size_t head;
+} MPMC;
+
+// rounds length up to a power of two so positions can be masked
+// Big O complexity: O(log n)
+static size_t roundUp(int length) {
+  size_t n = 2;
+  while (n < (size_t)length) {
+    n *= 2;
+  }
+  return n;
+}
+
+// creates an empty SPSC queue that holds at least length items
+// Big O complexity: O(1)
+SPSC *createSPSC(int length) {
+  assert(length > 0);
+
+  SPSC *qp = aligned_alloc(CACHE_LINE, sizeof(SPSC));
+  assert(qp != NULL);
+
+  qp->mask = roundUp(length) - 1;
+  qp->data = malloc(sizeof(void *) * (qp->mask + 1));
+  assert(qp->data != NULL);
+
+  atomic_init(&qp->head, 0);
+  atomic_init(&qp->tail, 0);
+  qp->cachedHead = qp->cachedTail = 0;
+
+  return qp;
+}
+
+// destroys SPSC queue, items themselves are not freed
+// Big O complexity: O(1)
+void destroySPSC(SPSC *qp) {
+  assert(qp != NULL);
+  free(qp->data);
+  free(qp);
+}
+
+// adds item to the rear of the queue, returns false if the queue is full
+// must only be called from the producer thread
+// Big O complexity: O(1), wait-free
+bool enqueueSPSC(SPSC *qp, void *item) {
+  assert(qp != NULL && item != NULL);
+  size_t tail = atomic_load_explicit(&qp->tail, memory_order_relaxed);
+
+  // only look at the consumer's line when our old copy says we are full
+  if (tail - qp->cachedHead > qp->mask) {
+    qp->cachedHead = atomic_load_explicit(&qp->head, memory_order_acquire);
+    if (tail - qp->cachedHead > qp->mask) {
+      return false;
+    }
+  }
+
+  qp->data[tail & qp->mask] = item;
+  // release publishes the item together with the new tail
+  atomic_store_explicit(&qp->tail, tail + 1, memory_order_release);
+
+  return true;
+}
+
+// removes the item at the front of the queue, returns NULL if it is empty
+// must only be called from the consumer thread
+// Big O complexity: O(1), wait-free
+void *dequeueSPSC(SPSC *qp) {
+  assert(qp != NULL);
+  size_t head = atomic_load_explicit(&qp->head, memory_order_relaxed);
+
+  // only look at the producer's line when our old copy says we are empty
+  if (head == qp->cachedTail) {
+    qp->cachedTail = atomic_load_explicit(&qp->tail, memory_order_acquire);
+    if (head == qp->cachedTail) {
+      return NULL;
+    }
+  }
+
+  void *item = qp->data[head & qp->mask];
+  // release hands the slot back to the producer
+  atomic_store_explicit(&qp->head, head + 1, memory_order_release);
+
+  return item;
+}
+
+// creates an empty MPMC queue that holds at least length items
+// Big O complexity: O(n), where n is the length of the queue
+MPMC *createMPMC(int length) {
+  assert(length > 0);
+
+  MPMC *qp = aligned_alloc(CACHE_LINE, sizeof(MPMC));
+  assert(qp != NULL);
+
+  qp->mask = roundUp(length) - 1;
+  qp->slots = malloc(sizeof(SLOT) * (qp->mask + 1));
+  assert(qp->slots != NULL);
+
+  // slot i is first ready for the enqueue at position i
+  size_t i;
+  for (i = 0; i <= qp->mask; i++) {
+    atomic_init(&qp->slots[i].seq, i);
+  }
+
+  atomic_init(&qp->head, 0);
+  atomic_init(&qp->tail, 0);
+
+  return qp;
+}
+
+// destroys MPMC queue, items themselves are not freed
+// Big O complexity: O(1)
+void destroyMPMC(MPMC *qp) {
+  assert(qp != NULL);
+  free(qp->slots);
+  free(qp);
+}
+
+// adds item to the rear of the queue, returns false if the queue is full
+// Big O complexity: O(1), lock-free
+bool enqueueMPMC(MPMC *qp, void *item) {
+  assert(qp != NULL && item != NULL);
+  SLOT *slot;
+  size_t pos = atomic_load_explicit(&qp->tail, memory_order_relaxed);
+
+  while (1) {
+    slot = &qp->slots[pos & qp->mask];
+    size_t seq = atomic_load_explicit(&slot->seq, memory_order_acquire);
+    intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+
+    if (diff == 0) {
+      // slot is free for this position, try to claim it
+      if (atomic_compare_exchange_weak_explicit(
+              &qp->tail, &pos, pos + 1, memory_order_relaxed,
+              memory_order_relaxed)) {
+        break;
+      }
+      // failed exchange already reloaded pos
+    } else if (diff < 0) {
+      // slot still holds the item from one lap ago
+      return false;
+    } else {
+      // another producer got here first
+      pos = atomic_load_explicit(&qp->tail, memory_order_relaxed);
+    }
+  }
+
+  slot->data = item;
+  // tell consumers the slot at pos is filled
+  atomic_store_explicit(&slot->seq, pos + 1, memory_order_release);
+
+  return true;
+}
+
+// removes the item at the front of the queue, returns NULL if it is empty
+// Big O complexity: O(1), lock-free
+void *dequeueMPMC(MPMC *qp) {
+  assert(qp != NULL);
+  SLOT *slot;
+  size_t pos = atomic_load_explicit(&qp->head, memory_order_relaxed);
+
+  while (1) {
+    slot = &qp->slots[pos & qp->mask];
+    size_t seq = atomic_load_explicit(&slot->seq, memory_order_acquire);
+    intptr_t diff = (intptr_t)seq - (intptr_t)(pos + 1);
+
+    if (diff == 0) {
+      // slot is filled for this position, try to claim it
+      if (atomic_compare_exchange_weak_explicit(
+              &qp->head, &pos, pos + 1, memory_order_relaxed,
+              memory_order_relaxed)) {
+        break;
+      }
+    } else if (diff < 0) {
+      // producer has not filled this slot yet
+      return NULL;
+    } else {
+      // another consumer got here first
+      pos = atomic_load_explicit(&qp->head, memory_order_relaxed);
+    }
+  }
+
+  void *item = slot->data;
+  // slot is free again for the enqueue one lap later
+  atomic_store_explicit(&slot->seq, pos + qp->mask + 1, memory_order_release);
+
+  return item;
+}
@@ -0,0 +1,41 @@
+/*
+ * File:	queue.h
+ *
+ * Copyright:	2023, Vladimir Ceban
+ *
+ * Description:	This file contains the public function and type
+ *		declarations for two bounded concurrent queues of generic
+ *		pointer types.  The SPSC queue is a wait-free ring for
+ *		exactly one producer and one consumer thread.  The MPMC
+ *		queue allows any number of producers and consumers and uses
+ *		a sequence number per slot instead of locks.  Like the list,
+ *		the queues do not store null pointers, so a null return
+ *		value from a dequeue function means the queue was empty.
+ */
+
+# ifndef QUEUE_H
+# define QUEUE_H
+
+# include <stdbool.h>
+
+typedef struct spsc SPSC;
+
+typedef struct mpmc MPMC;
+
+extern SPSC *createSPSC(int length);
+
+extern void destroySPSC(SPSC *qp);
+
+extern bool enqueueSPSC(SPSC *qp, void *item);
+
+extern void *dequeueSPSC(SPSC *qp);
+
+extern MPMC *createMPMC(int length);
+
+extern void destroyMPMC(MPMC *qp);
+
+extern bool enqueueMPMC(MPMC *qp, void *item);
+
+extern void *dequeueMPMC(MPMC *qp);
+
+# endif /* QUEUE_H */